@@ -0,0 +1,39 @@
+#include <benchmark/benchmark.h>
+
+#include "../s21_allocator.h"
+#include "../s21_matrix_oop.h"
+
+// Small decompositions and operator chains with matrix storage from the heap
+// (arg 0) or from the thread-local pool (arg 1). The heap_allocs counter is
+// the number of blocks taken from the heap per iteration.
+
+namespace {
+
+void BM_SmallMatrixChurn(benchmark::State& state) {
+  // Every thread sets the same allocator, so the order does not matter.
+  s21::SetAllocator(state.range(0) ? s21::PoolAllocator()
+                                   : s21::HeapAllocator());
+  int n = static_cast<int>(state.range(1));
+  S21Matrix a(n, n);
+  for (int i = 0; i < n; i++)
+    for (int j = 0; j < n; j++) a(i, j) = (i * 7 + j * 3) % 11 + (i == j) * n;
+  if (state.thread_index() == 0) s21::ResetAllocationStats();
+  for (auto _ : state) {
+    S21Matrix inv = a.InverseMatrix();
+    S21Matrix c = a * inv - a * 2.0;
+    benchmark::DoNotOptimize(a.Determinant() + c(0, 0));
+  }
+  state.SetLabel(state.range(0) ? "pool" : "heap");
+  if (state.thread_index() != 0) return;
+  // Thread 0 reports the process-wide count for all threads' iterations.
+  state.counters["heap_allocs"] = benchmark::Counter(
+      static_cast<double>(s21::GetAllocationStats().heap_allocations),
+      benchmark::Counter::kAvgIterations);
+  s21::SetAllocator(s21::HeapAllocator());
+}
+
+}  // namespace
+
+BENCHMARK(BM_SmallMatrixChurn)
+    ->ArgsProduct({{0, 1}, {4, 16, 64}})
+    ->ThreadRange(1, 4);
@@ -0,0 +1,58 @@
+#include <benchmark/benchmark.h>
+
+#include "../s21_matrix_batch.h"
+
+// Determinants and inverses of 10000 small matrices, one S21Matrix at a time
+// (arg 0) or as one S21MatrixBatch (arg 1).
+
+namespace {
+
+constexpr int kBatch = 10000;
+
+void BM_SmallInverse(benchmark::State& state) {
+  int n = static_cast<int>(state.range(1));
+  S21MatrixBatch batch(kBatch, n, n);
+  for (int b = 0; b < kBatch; b++)
+    for (int i = 0; i < n; i++)
+      for (int j = 0; j < n; j++)
+        batch(b, i, j) = (b + i * 7 + j * 3) % 11 + (i == j) * n;
+  std::vector<S21Matrix> single;
+  for (int b = 0; b < kBatch; b++) single.push_back(batch.Get(b));
+  for (auto _ : state) {
+    if (state.range(0)) {
+      benchmark::DoNotOptimize(batch.Determinant());
+      benchmark::DoNotOptimize(batch.InverseMatrix());
+    } else {
+      for (S21Matrix& m : single) {
+        benchmark::DoNotOptimize(m.Determinant());
+        benchmark::DoNotOptimize(m.InverseMatrix());
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kBatch);
+  state.SetLabel(state.range(0) ? "batch" : "single");
+}
+
+void BM_SmallProduct(benchmark::State& state) {
+  int n = static_cast<int>(state.range(1));
+  S21MatrixBatch a(kBatch, n, n);
+  for (int b = 0; b < kBatch; b++)
+    for (int i = 0; i < n; i++)
+      for (int j = 0; j < n; j++) a(b, i, j) = (b + i + j) % 5;
+  std::vector<S21Matrix> single;
+  for (int b = 0; b < kBatch; b++) single.push_back(a.Get(b));
+  for (auto _ : state) {
+    if (state.range(0)) {
+      benchmark::DoNotOptimize(a * a);
+    } else {
+      for (S21Matrix& m : single) benchmark::DoNotOptimize(m * m);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kBatch);
+  state.SetLabel(state.range(0) ? "batch" : "single");
+}
+
+}  // namespace
+
+BENCHMARK(BM_SmallInverse)->ArgsProduct({{0, 1}, {4, 8, 32}});
+BENCHMARK(BM_SmallProduct)->ArgsProduct({{0, 1}, {4, 8, 32}});
@@ -0,0 +1,62 @@
+#!/usr/bin/env python3
+"""Compares two Google Benchmark JSON reports, as written by `make benchmark`.
+
+Prints the change in real time of every benchmark present in both files and
+exits with status 1 if any got slower than the baseline by more than the
+threshold, a fraction (0.1 allows 10%). When a report has several
+repetitions of a benchmark, their median is used.
+"""
+
+import argparse
+import json
+import statistics
+import sys
+
+NS_PER_UNIT = {"ns": 1, "us": 1e3, "ms": 1e6, "s": 1e9}
+
+
+def load(path):
+    with open(path) as f:
+        report = json.load(f)
+    times = {}
+    for run in report["benchmarks"]:
+        if run.get("run_type", "iteration") != "iteration":
+            continue
+        if run.get("error_occurred"):
+            continue
+        ns = run["real_time"] * NS_PER_UNIT[run.get("time_unit", "ns")]
+        times.setdefault(run["run_name"] if "run_name" in run
+                         else run["name"], []).append(ns)
+    return {name: statistics.median(ns) for name, ns in times.items()}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--threshold", type=float, default=0.1)
+    args = parser.parse_args()
+
+    baseline = load(args.baseline)
+    current = load(args.current)
+    regressions = 0
+    print(f"{'benchmark':<50} {'baseline ns':>14} {'current ns':>14} "
+          f"{'change':>8}")
+    for name in sorted(baseline.keys() & current.keys()):
+        change = current[name] / baseline[name] - 1
+        flag = ""
+        if change > args.threshold:
+            flag = "  REGRESSION"
+            regressions += 1
+        print(f"{name:<50} {baseline[name]:>14.0f} {current[name]:>14.0f} "
+              f"{change:>+8.1%}{flag}")
+    for name in sorted(baseline.keys() - current.keys()):
+        print(f"{name:<50} missing from {args.current}")
+    print(f"{regressions} of {len(baseline.keys() & current.keys())} "
+          f"benchmarks slower than the baseline by more than "
+          f"{args.threshold:.0%}")
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,54 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "../s21_matrix_io.h"
+
+// Getting a 1024 x 1024 matrix from a file: parsed from text element by
+// element (arg 0), read with LoadMatrix (arg 1) or mapped with
+// S21MappedMatrix (arg 2), touching one element. The file is in the page
+// cache, so this measures the work on top of the disk.
+
+namespace {
+
+constexpr int kN = 1024;
+
+void BM_OpenMatrixFile(benchmark::State& state) {
+  std::string path = "s21_io_bench.tmp";
+  S21Matrix a(kN, kN);
+  for (int i = 0; i < kN; i++)
+    for (int j = 0; j < kN; j++) a(i, j) = (i * 31 + j * 17) % 101 / 7.0;
+  if (state.range(0) == 0) {
+    std::ofstream out(path);
+    out.precision(17);
+    out << kN << ' ' << kN << '\n';
+    for (int i = 0; i < kN; i++)
+      for (int j = 0; j < kN; j++) out << a(i, j) << ' ';
+  } else {
+    SaveMatrix(path, a);
+  }
+  for (auto _ : state) {
+    if (state.range(0) == 0) {
+      std::ifstream in(path);
+      int rows, cols;
+      in >> rows >> cols;
+      S21Matrix m(rows, cols);
+      for (int i = 0; i < rows; i++)
+        for (int j = 0; j < cols; j++) in >> m(i, j);
+      benchmark::DoNotOptimize(m(kN / 2, kN / 2));
+    } else if (state.range(0) == 1) {
+      benchmark::DoNotOptimize(LoadMatrix<double>(path)(kN / 2, kN / 2));
+    } else {
+      benchmark::DoNotOptimize(S21MappedMatrix<double>(path)(kN / 2, kN / 2));
+    }
+  }
+  std::remove(path.c_str());
+  const char* labels[] = {"text", "load", "mmap"};
+  state.SetLabel(labels[state.range(0)]);
+}
+
+}  // namespace
+
+BENCHMARK(BM_OpenMatrixFile)->DenseRange(0, 2)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,158 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+
+#include "../s21_matrix_oop.h"
+
+// The S21Matrix operations on square matrices of 2 to 4096 rows and on a few
+// product shapes. Besides the time, every benchmark reports its arithmetic
+// rate as "flops" (a G suffix means GFLOP/s) and bytes_per_second for one
+// pass over its operands and result, so sizes can be compared with each
+// other and with the machine's peak. The smallest sizes measure call
+// overhead more than throughput.
+
+namespace {
+
+// Diagonally dominant when square, so every size is well conditioned.
+S21Matrix Filled(int rows, int cols) {
+  S21Matrix a(rows, cols);
+  for (int i = 0; i < rows; i++)
+    for (int j = 0; j < cols; j++)
+      a(i, j) = (i * 7 + j * 3) % 11 - 5 + (i == j) * cols;
+  return a;
+}
+
+void Report(benchmark::State& state, double flops, double bytes) {
+  double iterations = static_cast<double>(state.iterations());
+  state.counters["flops"] =
+      benchmark::Counter(flops * iterations, benchmark::Counter::kIsRate);
+  state.SetBytesProcessed(static_cast<std::int64_t>(bytes * iterations));
+}
+
+double Elements(int rows, int cols) {
+  return static_cast<double>(rows) * cols * sizeof(double);
+}
+
+void BM_MulMatrix(benchmark::State& state) {
+  int n = static_cast<int>(state.range(0));
+  S21Matrix a = Filled(n, n), b = Filled(n, n);
+  for (auto _ : state) benchmark::DoNotOptimize(a * b);
+  Report(state, 2.0 * n * n * n, 3 * Elements(n, n));
+}
+
+// m x k times k x n.
+void BM_MulMatrixShape(benchmark::State& state) {
+  int m = static_cast<int>(state.range(0));
+  int k = static_cast<int>(state.range(1));
+  int n = static_cast<int>(state.range(2));
+  S21Matrix a = Filled(m, k), b = Filled(k, n);
+  for (auto _ : state) benchmark::DoNotOptimize(a * b);
+  Report(state, 2.0 * m * n * k,
+         Elements(m, k) + Elements(k, n) + Elements(m, n));
+}
+
+void BM_Determinant(benchmark::State& state) {
+  int n = static_cast<int>(state.range(0));
+  S21Matrix a = Filled(n, n);
+  for (auto _ : state) benchmark::DoNotOptimize(a.Determinant());
+  Report(state, 2.0 / 3 * n * n * n, Elements(n, n));
+}
+
+void BM_InverseMatrix(benchmark::State& state) {
+  int n = static_cast<int>(state.range(0));
+  S21Matrix a = Filled(n, n);
+  for (auto _ : state) benchmark::DoNotOptimize(a.InverseMatrix());
+  Report(state, 2.0 * n * n * n, 2 * Elements(n, n));
+}
+
+// One right-hand side; compare with BM_InverseMatrix, which is the rest of
+// the old way of solving.
+void BM_Solve(benchmark::State& state) {
+  int n = static_cast<int>(state.range(0));
+  S21Matrix a = Filled(n, n), b = Filled(n, 1);
+  for (auto _ : state) benchmark::DoNotOptimize(a.Solve(b));
+  Report(state, 2.0 / 3 * n * n * n + 2.0 * n * n, Elements(n, n));
+}
+
+void BM_Transpose(benchmark::State& state) {
+  int n = static_cast<int>(state.range(0));
+  S21Matrix a = Filled(n, n);
+  for (auto _ : state) benchmark::DoNotOptimize(a.Transpose());
+  Report(state, 0, 2 * Elements(n, n));
+}
+
+void BM_SumMatrix(benchmark::State& state) {
+  int n = static_cast<int>(state.range(0));
+  S21Matrix a = Filled(n, n), b = Filled(n, n);
+  for (auto _ : state) {
+    a.SumMatrix(b);
+    benchmark::ClobberMemory();
+  }
+  Report(state, 1.0 * n * n, 3 * Elements(n, n));
+}
+
+void BM_MulNumber(benchmark::State& state) {
+  int n = static_cast<int>(state.range(0));
+  S21Matrix a = Filled(n, n);
+  for (auto _ : state) {
+    a.MulNumber(1.0);
+    benchmark::ClobberMemory();
+  }
+  Report(state, 1.0 * n * n, 2 * Elements(n, n));
+}
+
+// One fused pass through the expression templates.
+void BM_OperatorChain(benchmark::State& state) {
+  int n = static_cast<int>(state.range(0));
+  S21Matrix a = Filled(n, n), b = Filled(n, n);
+  for (auto _ : state) {
+    S21Matrix c = a + b * 2.0 - a;
+    benchmark::DoNotOptimize(c.data());
+  }
+  Report(state, 3.0 * n * n, 3 * Elements(n, n));
+}
+
+// Streaming ingestion: grows an n x 64 matrix one row at a time. There is
+// no arithmetic, so it reports rows per second; a rate that holds up as n
+// grows means the growth is amortized.
+void BM_AppendRows(benchmark::State& state) {
+  int n = static_cast<int>(state.range(0)), cols = 64;
+  for (auto _ : state) {
+    S21Matrix a(0, cols);
+    for (int i = 0; i < n; i++) {
+      a.set_rows(i + 1);
+      a(i, 0) = i;
+    }
+    benchmark::DoNotOptimize(a.data());
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+void Sizes(benchmark::internal::Benchmark* b) {
+  b->RangeMultiplier(2)->Range(2, 4096)->Unit(benchmark::kMicrosecond);
+}
+
+// Square, outer product, inner product, panel times block and the
+// matrix-vector product.
+void Shapes(benchmark::internal::Benchmark* b) {
+  b->Args({1024, 1024, 1024})
+      ->Args({4096, 16, 4096})
+      ->Args({16, 4096, 16})
+      ->Args({4096, 256, 256})
+      ->Args({256, 4096, 256})
+      ->Args({4096, 4096, 1})
+      ->Unit(benchmark::kMicrosecond);
+}
+
+}  // namespace
+
+BENCHMARK(BM_MulMatrix)->Apply(Sizes);
+BENCHMARK(BM_MulMatrixShape)->Apply(Shapes);
+BENCHMARK(BM_Determinant)->Apply(Sizes);
+BENCHMARK(BM_InverseMatrix)->Apply(Sizes);
+BENCHMARK(BM_Solve)->Apply(Sizes);
+BENCHMARK(BM_Transpose)->Apply(Sizes);
+BENCHMARK(BM_SumMatrix)->Apply(Sizes);
+BENCHMARK(BM_MulNumber)->Apply(Sizes);
+BENCHMARK(BM_OperatorChain)->Apply(Sizes);
+BENCHMARK(BM_AppendRows)->Apply(Sizes);
@@ -0,0 +1,86 @@
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "../s21_simd.h"
+
+// Element-wise row kernels at every instruction set level this CPU supports,
+// so the speedup over the scalar baseline can be read off directly.
+
+namespace {
+
+template <class Kernel>
+void RunAtLevel(benchmark::State& state, Kernel kernel, int streams) {
+  auto level = static_cast<s21::SimdLevel>(state.range(0));
+  if (level > s21::DetectSimdLevel()) {
+    state.SkipWithError("instruction set not supported on this CPU");
+    return;
+  }
+  s21::SetSimdLevel(level);
+  int n = static_cast<int>(state.range(1));
+  std::vector<double> a(n, 1.0), b(n, 1e-9);
+  for (auto _ : state) {
+    kernel(a.data(), b.data(), n);
+    benchmark::ClobberMemory();
+  }
+  s21::SetSimdLevel(s21::DetectSimdLevel());
+  state.SetLabel(s21::SimdLevelName(level));
+  state.SetBytesProcessed(state.iterations() * streams * n * sizeof(double));
+}
+
+void BM_AddRow(benchmark::State& state) {
+  RunAtLevel(
+      state, [](double* a, const double* b, int n) { s21::AddRow(a, b, n); },
+      3);
+}
+
+void BM_ScaleRow(benchmark::State& state) {
+  RunAtLevel(
+      state, [](double* a, const double*, int n) { s21::ScaleRow(a, 1.0, n); },
+      2);
+}
+
+void BM_EqRow(benchmark::State& state) {
+  // Comparing a row with itself never exits early.
+  RunAtLevel(
+      state,
+      [](double* a, const double*, int n) {
+        benchmark::DoNotOptimize(s21::EqRow(a, a, n));
+      },
+      2);
+}
+
+void BM_NearRowRelative(benchmark::State& state) {
+  RunAtLevel(
+      state,
+      [](double* a, const double*, int n) {
+        benchmark::DoNotOptimize(
+            s21::NearRow(a, a, n, s21::Tolerance::Relative(1e-12)));
+      },
+      2);
+}
+
+void BM_NearRowUlp(benchmark::State& state) {
+  RunAtLevel(
+      state,
+      [](double* a, const double*, int n) {
+        benchmark::DoNotOptimize(s21::NearRow(a, a, n, s21::Tolerance::Ulp(4)));
+      },
+      2);
+}
+
+void Levels(benchmark::internal::Benchmark* b) {
+  for (int level = 0; level <= static_cast<int>(s21::SimdLevel::kAvx512);
+       level++)
+    for (int n : {256, 4096, 1 << 20}) b->Args({level, n});
+}
+
+}  // namespace
+
+BENCHMARK(BM_AddRow)->Apply(Levels);
+BENCHMARK(BM_ScaleRow)->Apply(Levels);
+BENCHMARK(BM_EqRow)->Apply(Levels);
+BENCHMARK(BM_NearRowRelative)->Apply(Levels);
+BENCHMARK(BM_NearRowUlp)->Apply(Levels);
+
+BENCHMARK_MAIN();
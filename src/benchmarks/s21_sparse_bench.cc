@@ -0,0 +1,60 @@
+#include <benchmark/benchmark.h>
+
+#include "../s21_sparse_matrix.h"
+
+// Matrix-vector and matrix-matrix products of a 2048 x 2048 matrix with
+// density arg 1 per mille, stored dense (arg 0) or as S21SparseMatrix
+// (arg 1).
+
+namespace {
+
+constexpr int kN = 2048;
+
+S21Matrix Scattered(int per_mille) {
+  S21Matrix a(kN, kN);
+  unsigned seed = 12345;
+  for (int i = 0; i < kN; i++)
+    for (int j = 0; j < kN; j++) {
+      seed = seed * 1103515245 + 12345;
+      if (static_cast<int>(seed >> 16) % 1000 < per_mille) a(i, j) = i - j;
+    }
+  return a;
+}
+
+void BM_SparseMatVec(benchmark::State& state) {
+  S21Matrix a = Scattered(static_cast<int>(state.range(1)));
+  S21SparseMatrix s = S21SparseMatrix::FromDense(a);
+  S21Matrix x(kN, 1), y(kN, 1);
+  for (int i = 0; i < kN; i++) x(i, 0) = i % 7;
+  for (auto _ : state) {
+    if (state.range(0)) {
+      s.MulVector(S21Span<const double>(x.data(), kN),
+                  S21Span<double>(y.data(), kN));
+    } else {
+      y.Gemm(1, a, x, 0);
+    }
+    benchmark::DoNotOptimize(y.data());
+  }
+  state.SetLabel(state.range(0) ? "sparse" : "dense");
+}
+
+void BM_SparseMatMat(benchmark::State& state) {
+  S21Matrix a = Scattered(static_cast<int>(state.range(1)));
+  S21SparseMatrix s = S21SparseMatrix::FromDense(a);
+  S21Matrix x(kN, 64);
+  for (int i = 0; i < kN; i++)
+    for (int j = 0; j < 64; j++) x(i, j) = (i + j) % 7;
+  for (auto _ : state) {
+    if (state.range(0)) {
+      benchmark::DoNotOptimize(s * x);
+    } else {
+      benchmark::DoNotOptimize(a * x);
+    }
+  }
+  state.SetLabel(state.range(0) ? "sparse" : "dense");
+}
+
+}  // namespace
+
+BENCHMARK(BM_SparseMatVec)->ArgsProduct({{0, 1}, {1, 10, 100, 300}});
+BENCHMARK(BM_SparseMatMat)->ArgsProduct({{0, 1}, {1, 10, 100, 300}});
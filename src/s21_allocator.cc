@@ -0,0 +1,166 @@
+#include "s21_allocator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <new>
+
+namespace s21 {
+
+namespace {
+
+std::atomic<long> allocations{0};
+std::atomic<long> deallocations{0};
+std::atomic<long> heap_allocations{0};
+std::atomic<long> heap_bytes{0};
+
+// nullptr stands for HeapAllocator().
+std::atomic<Allocator*> current{nullptr};
+
+thread_local int no_heap_depth = 0;
+
+void* HeapAlloc(std::size_t bytes) {
+  if (no_heap_depth > 0) throw std::bad_alloc();
+  heap_allocations.fetch_add(1, std::memory_order_relaxed);
+  heap_bytes.fetch_add(static_cast<long>(bytes), std::memory_order_relaxed);
+  return ::operator new(bytes, std::align_val_t(kAllocAlign));
+}
+
+void HeapFree(void* p) noexcept {
+  ::operator delete(p, std::align_val_t(kAllocAlign));
+}
+
+class Heap final : public Allocator {
+ protected:
+  void* DoAllocate(std::size_t bytes) override { return HeapAlloc(bytes); }
+  void DoDeallocate(void* p, std::size_t) noexcept override { HeapFree(p); }
+};
+
+// Size classes are the powers of two from 64 bytes to kPoolMaxBytes.
+constexpr int kMinShift = 6;
+constexpr int kMaxShift = 22;
+constexpr int kClasses = kMaxShift - kMinShift + 1;
+static_assert(kPoolMaxBytes == std::size_t{1} << kMaxShift);
+static_assert(std::size_t{1} << kMinShift >= kAllocAlign);
+
+int SizeClass(std::size_t bytes) {
+  int c = 0;
+  while (std::size_t{1} << (kMinShift + c) < bytes) c++;
+  return c;
+}
+
+int CacheLimit(int c) {
+  return static_cast<int>(
+      std::max<std::size_t>(4, kPoolCacheBytes >> (kMinShift + c)));
+}
+
+// Free blocks are chained through their first bytes.
+struct FreeBlock {
+  FreeBlock* next;
+};
+
+// The free lists are trivially destructible, so they can still be inspected
+// after the thread's cleanup has run; cache_closed then sends blocks returned
+// late, e.g. by static matrices at exit, back to the heap.
+struct PoolCache {
+  FreeBlock* head[kClasses];
+  int count[kClasses];
+};
+thread_local PoolCache cache;
+thread_local bool cache_closed = false;
+
+struct CacheReaper {
+  bool armed = false;
+  ~CacheReaper() {
+    for (int c = 0; c < kClasses; c++)
+      while (FreeBlock* b = cache.head[c]) {
+        cache.head[c] = b->next;
+        HeapFree(b);
+      }
+    cache_closed = true;
+  }
+};
+thread_local CacheReaper reaper;
+
+class Pool final : public Allocator {
+ protected:
+  void* DoAllocate(std::size_t bytes) override {
+    if (bytes > kPoolMaxBytes) return HeapAlloc(bytes);
+    int c = SizeClass(bytes);
+    if (FreeBlock* b = cache.head[c]) {
+      cache.head[c] = b->next;
+      cache.count[c]--;
+      return b;
+    }
+    return HeapAlloc(std::size_t{1} << (kMinShift + c));
+  }
+
+  void DoDeallocate(void* p, std::size_t bytes) noexcept override {
+    if (bytes <= kPoolMaxBytes && !cache_closed) {
+      int c = SizeClass(bytes);
+      if (cache.count[c] < CacheLimit(c)) {
+        // Touching the reaper registers its destructor for this thread.
+        reaper.armed = true;
+        FreeBlock* b = static_cast<FreeBlock*>(p);
+        b->next = cache.head[c];
+        cache.head[c] = b;
+        cache.count[c]++;
+        return;
+      }
+    }
+    HeapFree(p);
+  }
+};
+
+}  // namespace
+
+void* Allocator::Allocate(std::size_t bytes) {
+  void* p = DoAllocate(bytes);
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  return p;
+}
+
+void Allocator::Deallocate(void* p, std::size_t bytes) noexcept {
+  deallocations.fetch_add(1, std::memory_order_relaxed);
+  DoDeallocate(p, bytes);
+}
+
+// Both are never destroyed, so matrices with static storage duration can
+// still free through them at exit.
+Allocator& HeapAllocator() {
+  static Heap* heap = new Heap;
+  return *heap;
+}
+
+Allocator& PoolAllocator() {
+  static Pool* pool = new Pool;
+  return *pool;
+}
+
+void SetAllocator(Allocator& alloc) {
+  current.store(&alloc, std::memory_order_release);
+}
+
+Allocator& CurrentAllocator() {
+  Allocator* alloc = current.load(std::memory_order_acquire);
+  return alloc != nullptr ? *alloc : HeapAllocator();
+}
+
+AllocationStats GetAllocationStats() {
+  return {allocations.load(std::memory_order_relaxed),
+          deallocations.load(std::memory_order_relaxed),
+          heap_allocations.load(std::memory_order_relaxed),
+          heap_bytes.load(std::memory_order_relaxed)};
+}
+
+void ResetAllocationStats() {
+  allocations = 0;
+  deallocations = 0;
+  heap_allocations = 0;
+  heap_bytes = 0;
+}
+
+NoHeapScope::NoHeapScope() { no_heap_depth++; }
+
+NoHeapScope::~NoHeapScope() { no_heap_depth--; }
+
+}  // namespace s21
@@ -0,0 +1,115 @@
+#ifndef CPP1_S21_MATRIXPLUS_1_S21_ALLOCATOR_H
+#define CPP1_S21_MATRIXPLUS_1_S21_ALLOCATOR_H
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+namespace s21 {
+
+// Alignment of every block handed out by an Allocator, one cache line.
+constexpr std::size_t kAllocAlign = 64;
+
+// Source of matrix storage and of the scratch arrays used by decompositions.
+// Implementations must be thread-safe: blocks are requested and returned on
+// pool workers as well, and a block may be returned on a thread other than
+// the one that requested it.
+class Allocator {
+ public:
+  virtual ~Allocator() = default;
+  // Forwards to DoAllocate and counts the block. bytes > 0; throws
+  // std::bad_alloc on failure.
+  void* Allocate(std::size_t bytes);
+  // p came from Allocate(bytes) on this allocator.
+  void Deallocate(void* p, std::size_t bytes) noexcept;
+
+ protected:
+  // Must return kAllocAlign-aligned memory.
+  virtual void* DoAllocate(std::size_t bytes) = 0;
+  virtual void DoDeallocate(void* p, std::size_t bytes) noexcept = 0;
+};
+
+// Aligned global operator new and delete. The default.
+Allocator& HeapAllocator();
+// Size-class pool for short-lived temporaries: requests up to kPoolMaxBytes
+// are rounded up to a power of two and recycled through free lists private
+// to each thread, so a returned block is reused by the next request of that
+// size on the same thread without touching the heap or taking a lock. Each
+// thread caches at most max(4, kPoolCacheBytes / size) blocks per size and
+// releases them when it exits. Larger requests go straight to the heap.
+Allocator& PoolAllocator();
+constexpr std::size_t kPoolMaxBytes = std::size_t{1} << 22;
+constexpr std::size_t kPoolCacheBytes = std::size_t{1} << 20;
+
+// Allocator for matrices and scratch arrays created from now on; a matrix
+// keeps the allocator it was created with and frees its storage through it.
+// The allocator must outlive every matrix created from it.
+void SetAllocator(Allocator& alloc);
+[[nodiscard]] Allocator& CurrentAllocator();
+
+// Process-wide counts since the last reset. `allocations` counts requests to
+// any Allocator; `heap_allocations` and `heap_bytes` count the blocks the
+// built-in allocators actually took from the heap, i.e. pool misses.
+struct AllocationStats {
+  long allocations;
+  long deallocations;
+  long heap_allocations;
+  long heap_bytes;
+};
+[[nodiscard]] AllocationStats GetAllocationStats();
+void ResetAllocationStats();
+
+// While an instance is alive, any heap allocation by the built-in allocators
+// on the constructing thread throws std::bad_alloc. With PoolAllocator()
+// this turns a warmed-up hot section into one that makes no s21::Allocator
+// heap allocations: a pool miss fails loudly instead of silently hitting the
+// heap. Memory taken outside s21::Allocator is not seen: GEMM keeps packing
+// buffers per thread, allocated by the first blocked product on that thread
+// and reused from then on. Only the calling thread is covered, not pool
+// workers.
+class NoHeapScope {
+ public:
+  NoHeapScope();
+  NoHeapScope(const NoHeapScope&) = delete;
+  NoHeapScope& operator=(const NoHeapScope&) = delete;
+  ~NoHeapScope();
+};
+
+// Fixed-size array of trivially destructible elements from
+// CurrentAllocator(), value-initialized, for scratch space such as pivot
+// permutations.
+template <class T>
+class ScratchBuffer {
+  static_assert(std::is_trivially_destructible_v<T>);
+
+ public:
+  explicit ScratchBuffer(std::size_t size)
+      : alloc_(&CurrentAllocator()), data_(nullptr), size_(size) {
+    if (size_ > 0) {
+      data_ = static_cast<T*>(alloc_->Allocate(Bytes()));
+      std::uninitialized_value_construct_n(data_, size_);
+    }
+  }
+  ScratchBuffer(const ScratchBuffer&) = delete;
+  ScratchBuffer& operator=(const ScratchBuffer&) = delete;
+  ~ScratchBuffer() {
+    if (data_ != nullptr) alloc_->Deallocate(data_, Bytes());
+  }
+
+  [[nodiscard]] T* data() { return data_; }
+  [[nodiscard]] std::size_t size() const { return size_; }
+  T& operator[](std::size_t i) { return data_[i]; }
+
+ private:
+  [[nodiscard]] std::size_t Bytes() const {
+    return size_ * sizeof(T);
+  }
+
+  Allocator* alloc_;
+  T* data_;
+  std::size_t size_;
+};
+
+}  // namespace s21
+
+#endif  // CPP1_S21_MATRIXPLUS_1_S21_ALLOCATOR_H
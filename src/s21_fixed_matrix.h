@@ -0,0 +1,325 @@
+#ifndef CPP1_S21_MATRIXPLUS_1_S21_FIXED_MATRIX_H
+#define CPP1_S21_MATRIXPLUS_1_S21_FIXED_MATRIX_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "s21_matrix_oop.h"
+#include "s21_simd.h"
+
+// R x C matrix with the elements stored inline, for small transforms where a
+// heap allocation and runtime shape checks would cost more than the
+// arithmetic. Shapes are template arguments, so a product or sum of
+// mismatched matrices does not compile. Everything except EqMatrix is
+// constexpr; element-wise operations and products are unrolled through index
+// sequences, and determinants, complements and inverses use closed-form
+// cofactor expansion up to 4 x 4 and elimination above that.
+//
+// Element types are the real ones of S21BasicMatrix: float, double and
+// std::int64_t.
+template <int R, int C, class T = double>
+class S21FixedMatrix {
+  static_assert(R > 0 && C > 0, "fixed matrix dimensions must be positive");
+  static_assert(std::is_arithmetic_v<T>, "fixed matrices hold real numbers");
+
+ public:
+  using value_type = T;
+
+  constexpr S21FixedMatrix() : data_{} {}
+  // Elements in row-major order: S21FixedMatrix<2, 2>(1, 2, 3, 4).
+  template <class... Args,
+            class = std::enable_if_t<sizeof...(Args) == R * C &&
+                                     (std::is_arithmetic_v<Args> && ...)>>
+  constexpr explicit S21FixedMatrix(Args... args)
+      : data_{static_cast<T>(args)...} {}
+  // From a dynamic matrix or view of the same shape.
+  explicit S21FixedMatrix(S21BasicMatrixView<const T> m) : data_{} {
+    if (m.rows() != R || m.cols() != C) throw std::logic_error(CORRESPOND_MSG);
+    for (int i = 0; i < R; i++)
+      for (int j = 0; j < C; j++) data_[i * C + j] = m(i, j);
+  }
+  explicit operator S21BasicMatrix<T>() const {
+    S21BasicMatrix<T> res(R, C);
+    for (int i = 0; i < R; i++)
+      std::copy(data_ + i * C, data_ + (i + 1) * C,
+                res.data() + i * res.stride());
+    return res;
+  }
+  // Views let fixed and dynamic matrices meet in products and expressions
+  // without a copy.
+  [[nodiscard]] S21BasicMatrixView<T> View() { return {data_, R, C, C, 1}; }
+  [[nodiscard]] S21BasicMatrixView<const T> View() const {
+    return {data_, R, C, C, 1};
+  }
+
+  [[nodiscard]] static constexpr int rows() { return R; }
+  [[nodiscard]] static constexpr int cols() { return C; }
+  constexpr T& operator()(int i, int j) {
+    assert(i >= 0 && i < R && j >= 0 && j < C);
+    return data_[i * C + j];
+  }
+  constexpr const T& operator()(int i, int j) const {
+    assert(i >= 0 && i < R && j >= 0 && j < C);
+    return data_[i * C + j];
+  }
+  constexpr T& at(int i, int j) {
+    if (i < 0 || i >= R || j < 0 || j >= C) throw std::length_error(RANGE_MSG);
+    return data_[i * C + j];
+  }
+  constexpr const T& at(int i, int j) const {
+    if (i < 0 || i >= R || j < 0 || j >= C) throw std::length_error(RANGE_MSG);
+    return data_[i * C + j];
+  }
+  [[nodiscard]] constexpr T* data() { return data_; }
+  [[nodiscard]] constexpr const T* data() const { return data_; }
+
+  // Same rule as S21BasicMatrix<T>::EqMatrix.
+  bool EqMatrix(const S21FixedMatrix& other) const {
+    return s21::EqRow(data_, other.data_, R * C);
+  }
+  constexpr void SumMatrix(const S21FixedMatrix& other) {
+    Each([&](int k) { data_[k] += other.data_[k]; });
+  }
+  constexpr void SubMatrix(const S21FixedMatrix& other) {
+    Each([&](int k) { data_[k] -= other.data_[k]; });
+  }
+  constexpr void MulNumber(const T num) {
+    Each([&](int k) { data_[k] *= num; });
+  }
+  constexpr void MulMatrix(const S21FixedMatrix<C, C, T>& other) {
+    *this = *this * other;
+  }
+  [[nodiscard]] constexpr S21FixedMatrix<C, R, T> Transpose() const {
+    S21FixedMatrix<C, R, T> res;
+    Each([&](int k) { res.data_[k] = data_[k % R * C + k / R]; });
+    return res;
+  }
+  [[nodiscard]] constexpr T Determinant() const;
+  [[nodiscard]] constexpr S21FixedMatrix CalcComplements() const;
+  // Throws std::logic_error if the matrix is singular.
+  [[nodiscard]] constexpr S21FixedMatrix InverseMatrix() const;
+
+  // The matrix without row `row` and column `col`.
+  [[nodiscard]] constexpr S21FixedMatrix<R - 1, C - 1, T> Minor(
+      int row, int col) const {
+    S21FixedMatrix<R - 1, C - 1, T> res;
+    res.Each([&](int k) {
+      int i = k / (C - 1), j = k % (C - 1);
+      res.data_[k] = data_[(i + (i >= row)) * C + j + (j >= col)];
+    });
+    return res;
+  }
+
+  template <int K>
+  friend constexpr S21FixedMatrix<R, K, T> operator*(
+      const S21FixedMatrix& l, const S21FixedMatrix<C, K, T>& r) {
+    return Product(l, r);
+  }
+  friend constexpr S21FixedMatrix operator+(S21FixedMatrix l,
+                                            const S21FixedMatrix& r) {
+    l.SumMatrix(r);
+    return l;
+  }
+  friend constexpr S21FixedMatrix operator-(S21FixedMatrix l,
+                                            const S21FixedMatrix& r) {
+    l.SubMatrix(r);
+    return l;
+  }
+  friend constexpr S21FixedMatrix operator*(S21FixedMatrix l, const T num) {
+    l.MulNumber(num);
+    return l;
+  }
+  friend constexpr S21FixedMatrix operator*(const T num, S21FixedMatrix r) {
+    r.MulNumber(num);
+    return r;
+  }
+  bool operator==(const S21FixedMatrix& other) const {
+    return EqMatrix(other);
+  }
+  constexpr S21FixedMatrix& operator+=(const S21FixedMatrix& other) {
+    SumMatrix(other);
+    return *this;
+  }
+  constexpr S21FixedMatrix& operator-=(const S21FixedMatrix& other) {
+    SubMatrix(other);
+    return *this;
+  }
+  constexpr S21FixedMatrix& operator*=(const T num) {
+    MulNumber(num);
+    return *this;
+  }
+  constexpr S21FixedMatrix& operator*=(const S21FixedMatrix<C, C, T>& other) {
+    MulMatrix(other);
+    return *this;
+  }
+
+ private:
+  template <int R2, int C2, class T2>
+  friend class S21FixedMatrix;
+
+  // Largest order handled by cofactor expansion.
+  static constexpr int kClosedForm = 4;
+
+  // f(k) for every element index k, unrolled.
+  template <class F>
+  static constexpr void Each(F&& f) {
+    EachImpl(f, std::make_index_sequence<R * C>());
+  }
+  template <class F, std::size_t... K>
+  static constexpr void EachImpl(F& f, std::index_sequence<K...>) {
+    (f(static_cast<int>(K)), ...);
+  }
+  // a[0] * b[0] + a[1] * b[ldb] + ..., summed left to right.
+  template <std::size_t... P>
+  static constexpr T Dot(const T* a, const T* b, int ldb,
+                         std::index_sequence<P...>) {
+    return (... + (a[P] * b[P * ldb]));
+  }
+  static constexpr T Abs(T x) { return x < 0 ? -x : x; }
+  // std::swap is not constexpr before C++20.
+  static constexpr void Swap(T& a, T& b) {
+    T t = a;
+    a = b;
+    b = t;
+  }
+  static constexpr T CofactorSign(int i, int j) { return (i + j) % 2 ? -1 : 1; }
+
+  template <int K>
+  static constexpr S21FixedMatrix<R, K, T> Product(
+      const S21FixedMatrix& l, const S21FixedMatrix<C, K, T>& r) {
+    S21FixedMatrix<R, K, T> res;
+    res.Each([&](int k) {
+      res.data_[k] = Dot(l.data_ + k / K * C, r.data_ + k % K, K,
+                         std::make_index_sequence<C>());
+    });
+    return res;
+  }
+  constexpr T EliminationDeterminant() const;
+  constexpr S21FixedMatrix GaussJordanInverse() const;
+
+  T data_[R * C];
+};
+
+template <int R, int C, class T>
+constexpr T S21FixedMatrix<R, C, T>::Determinant() const {
+  static_assert(R == C, SQUARE_MSG);
+  if constexpr (R == 1) {
+    return data_[0];
+  } else if constexpr (R <= kClosedForm) {
+    // Expansion along the first row.
+    T det = 0;
+    for (int j = 0; j < C; j++)
+      det += CofactorSign(0, j) * data_[j] * Minor(0, j).Determinant();
+    return det;
+  } else {
+    return EliminationDeterminant();
+  }
+}
+
+// Partial-pivot LU on a copy, or fraction-free (Bareiss) elimination for
+// integers so that every division is exact.
+template <int R, int C, class T>
+constexpr T S21FixedMatrix<R, C, T>::EliminationDeterminant() const {
+  S21FixedMatrix a = *this;
+  T det = 1, prev = 1;
+  for (int k = 0; k < R; k++) {
+    int p = k;
+    for (int i = k + 1; i < R; i++)
+      if (Abs(a(i, k)) > Abs(a(p, k))) p = i;
+    if (a(p, k) == 0) return 0;
+    if (p != k) {
+      for (int j = 0; j < C; j++) Swap(a(k, j), a(p, j));
+      det = -det;
+    }
+    for (int i = k + 1; i < R; i++) {
+      if constexpr (std::is_integral_v<T>) {
+        for (int j = k + 1; j < C; j++)
+          a(i, j) = (a(i, j) * a(k, k) - a(i, k) * a(k, j)) / prev;
+      } else {
+        T l = a(i, k) / a(k, k);
+        for (int j = k + 1; j < C; j++) a(i, j) -= l * a(k, j);
+      }
+    }
+    if constexpr (std::is_integral_v<T>)
+      prev = a(k, k);
+    else
+      det *= a(k, k);
+  }
+  if constexpr (std::is_integral_v<T>) det *= a(R - 1, C - 1);
+  return det;
+}
+
+template <int R, int C, class T>
+constexpr S21FixedMatrix<R, C, T> S21FixedMatrix<R, C, T>::CalcComplements()
+    const {
+  static_assert(R == C, SQUARE_MSG);
+  if constexpr (R == 1) {
+    return *this;
+  } else {
+    S21FixedMatrix res;
+    Each([&](int k) {
+      int i = k / C, j = k % C;
+      res.data_[k] = CofactorSign(i, j) * Minor(i, j).Determinant();
+    });
+    return res;
+  }
+}
+
+template <int R, int C, class T>
+constexpr S21FixedMatrix<R, C, T> S21FixedMatrix<R, C, T>::InverseMatrix()
+    const {
+  static_assert(R == C, SQUARE_MSG);
+  static_assert(std::is_floating_point_v<T>, INTEGER_MSG);
+  if constexpr (R == 1) {
+    if (data_[0] == 0) throw std::logic_error(NULL_DET_MSG);
+    return S21FixedMatrix(1 / data_[0]);
+  } else if constexpr (R <= kClosedForm) {
+    // Adjugate over determinant, with the determinant taken from the first
+    // row of complements.
+    S21FixedMatrix comp = CalcComplements();
+    T det = Dot(data_, comp.data_, 1, std::make_index_sequence<C>());
+    if (det == 0) throw std::logic_error(NULL_DET_MSG);
+    S21FixedMatrix<C, R, T> res = comp.Transpose();
+    res.MulNumber(1 / det);
+    return res;
+  } else {
+    return GaussJordanInverse();
+  }
+}
+
+template <int R, int C, class T>
+constexpr S21FixedMatrix<R, C, T>
+S21FixedMatrix<R, C, T>::GaussJordanInverse() const {
+  S21FixedMatrix a = *this, inv;
+  for (int i = 0; i < R; i++) inv(i, i) = 1;
+  for (int k = 0; k < R; k++) {
+    int p = k;
+    for (int i = k + 1; i < R; i++)
+      if (Abs(a(i, k)) > Abs(a(p, k))) p = i;
+    if (a(p, k) == 0) throw std::logic_error(NULL_DET_MSG);
+    for (int j = 0; j < C; j++) {
+      Swap(a(k, j), a(p, j));
+      Swap(inv(k, j), inv(p, j));
+    }
+    T piv = a(k, k);
+    for (int j = 0; j < C; j++) {
+      a(k, j) /= piv;
+      inv(k, j) /= piv;
+    }
+    for (int i = 0; i < R; i++) {
+      T f = a(i, k);
+      if (i == k || f == 0) continue;
+      for (int j = 0; j < C; j++) {
+        a(i, j) -= f * a(k, j);
+        inv(i, j) -= f * inv(k, j);
+      }
+    }
+  }
+  return inv;
+}
+
+#endif  // CPP1_S21_MATRIXPLUS_1_S21_FIXED_MATRIX_H
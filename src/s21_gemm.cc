@@ -0,0 +1,423 @@
+#include "s21_gemm.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "s21_allocator.h"
+#include "s21_simd.h"
+#include "s21_thread_pool.h"
+
+namespace s21 {
+
+namespace {
+
+// Register tile computed by one micro-kernel call.
+constexpr int kMr = 4;
+constexpr int kNr = 4;
+// Cache blocks: a kKc x kNr panel of B stays in L1, a kMc x kKc block of A
+// in L2 and a kKc x kNc block of B in L3.
+constexpr int kMc = 128;
+constexpr int kKc = 256;
+constexpr int kNc = 2048;
+// Below this many multiply-adds packing costs more than it saves.
+constexpr long kSmallGemm = 48L * 48 * 48;
+// Width of the output tiles handed to pool threads, and the product size
+// from which splitting the work pays for the extra packing of B.
+constexpr int kTileCols = 512;
+constexpr long kParallelGemm = 128L * 128 * 128;
+// Crossover calibration times products of order 2 * kMinCrossover up to
+// kMaxCrossover; if the recursion never wins, it is only used from
+// 2 * kMaxCrossover on. Without a crossover set, products with a dimension
+// below kMinCrossover skip the recursion without measuring anything.
+constexpr int kMinCrossover = 128;
+constexpr int kMaxCrossover = 1024;
+
+typedef double V2 __attribute__((vector_size(16), aligned(8)));
+typedef float V4 __attribute__((vector_size(16), aligned(4)));
+
+std::ptrdiff_t Offset(int i, int ld) {
+  return static_cast<std::ptrdiff_t>(i) * ld;
+}
+
+template <class T>
+void ScaleC(int m, int n, T beta, T* c, int ldc) {
+  if (beta == T(1)) return;
+  for (int i = 0; i < m; i++) {
+    T* row = c + Offset(i, ldc);
+    if (beta == T(0))
+      std::fill(row, row + n, T(0));
+    else
+      for (int j = 0; j < n; j++) row[j] *= beta;
+  }
+}
+
+// Plain i-k-j loop for operands too small to amortize packing.
+template <class T>
+void SmallGemm(int m, int n, int k, T alpha, const T* a, int rsa, int csa,
+               const T* b, int rsb, int csb, T* c, int ldc) {
+  for (int i = 0; i < m; i++) {
+    T* crow = c + Offset(i, ldc);
+    const T* arow = a + Offset(i, rsa);
+    for (int p = 0; p < k; p++) {
+      const T* brow = b + Offset(p, rsb);
+      T aip = alpha * arow[Offset(p, csa)];
+      if (csb == 1)
+        for (int j = 0; j < n; j++) crow[j] += aip * brow[j];
+      else
+        for (int j = 0; j < n; j++) crow[j] += aip * brow[Offset(j, csb)];
+    }
+  }
+}
+
+// Copies an mc x kc block of A into panels of kMr rows. Each panel is stored
+// column by column so the micro-kernel reads it sequentially; the last panel
+// is zero-padded. Packing is also where arbitrary operand strides (e.g. a
+// transposed view) are absorbed.
+template <class T>
+void PackA(int mc, int kc, const T* a, int rsa, int csa, T* buf) {
+  for (int i = 0; i < mc; i += kMr) {
+    int mr = std::min(kMr, mc - i);
+    for (int r = 0; r < kMr; r++) {
+      const T* arow = a + Offset(i + r, rsa);
+      for (int p = 0; p < kc; p++)
+        buf[p * kMr + r] = r < mr ? arow[Offset(p, csa)] : T(0);
+    }
+    buf += kMr * kc;
+  }
+}
+
+// Copies a kc x nc block of B into panels of kNr columns, stored row by row
+// and zero-padded like PackA.
+template <class T>
+void PackB(int kc, int nc, const T* b, int rsb, int csb, T* buf) {
+  for (int j = 0; j < nc; j += kNr) {
+    int nr = std::min(kNr, nc - j);
+    for (int p = 0; p < kc; p++) {
+      const T* brow = b + Offset(p, rsb) + Offset(j, csb);
+      for (int s = 0; s < kNr; s++)
+        buf[s] = s < nr ? brow[Offset(s, csb)] : T(0);
+      buf += kNr;
+    }
+  }
+}
+
+// kMr x kNr outer-product accumulation over packed panels. The tile is
+// spelled out as named accumulators so they stay in vector registers for the
+// whole kc loop.
+void MicroKernel(int kc, const double* a, const double* b, double* out) {
+  V2 c00 = {}, c01 = {}, c10 = {}, c11 = {};
+  V2 c20 = {}, c21 = {}, c30 = {}, c31 = {};
+  for (int p = 0; p < kc; p++) {
+    V2 b0 = *reinterpret_cast<const V2*>(b);
+    V2 b1 = *reinterpret_cast<const V2*>(b + 2);
+    c00 += a[0] * b0;
+    c01 += a[0] * b1;
+    c10 += a[1] * b0;
+    c11 += a[1] * b1;
+    c20 += a[2] * b0;
+    c21 += a[2] * b1;
+    c30 += a[3] * b0;
+    c31 += a[3] * b1;
+    a += kMr;
+    b += kNr;
+  }
+  V2 acc[kMr][kNr / 2] = {{c00, c01}, {c10, c11}, {c20, c21}, {c30, c31}};
+  for (int r = 0; r < kMr; r++)
+    for (int s = 0; s < kNr; s++) out[r * kNr + s] = acc[r][s / 2][s % 2];
+}
+
+// The float tile: one V4 per row of the tile.
+void MicroKernel(int kc, const float* a, const float* b, float* out) {
+  V4 c0 = {}, c1 = {}, c2 = {}, c3 = {};
+  for (int p = 0; p < kc; p++) {
+    V4 b0 = *reinterpret_cast<const V4*>(b);
+    c0 += a[0] * b0;
+    c1 += a[1] * b0;
+    c2 += a[2] * b0;
+    c3 += a[3] * b0;
+    a += kMr;
+    b += kNr;
+  }
+  V4 acc[kMr] = {c0, c1, c2, c3};
+  for (int r = 0; r < kMr; r++)
+    for (int s = 0; s < kNr; s++) out[r * kNr + s] = acc[r][s];
+}
+
+// Element types without a vector tile.
+template <class T>
+void MicroKernel(int kc, const T* a, const T* b, T* out) {
+  T acc[kMr][kNr] = {};
+  for (int p = 0; p < kc; p++) {
+    for (int r = 0; r < kMr; r++)
+      for (int s = 0; s < kNr; s++) acc[r][s] += a[r] * b[s];
+    a += kMr;
+    b += kNr;
+  }
+  for (int r = 0; r < kMr; r++)
+    for (int s = 0; s < kNr; s++) out[r * kNr + s] = acc[r][s];
+}
+
+// Blocked product for one m x n tile of C, already scaled by beta. The
+// summation order of every element depends only on k, never on the tile
+// bounds, so any tiling of C gives bitwise-identical results.
+template <class T>
+void BlockedGemm(int m, int n, int k, T alpha, const T* a, int rsa, int csa,
+                 const T* b, int rsb, int csb, T* c, int ldc) {
+  thread_local std::vector<T> pack_a, pack_b;
+  pack_a.resize(static_cast<std::size_t>(kMc) * kKc);
+  pack_b.resize(static_cast<std::size_t>(kKc) * kNc);
+  T tile[kMr * kNr];
+
+  for (int jc = 0; jc < n; jc += kNc) {
+    int nc = std::min(kNc, n - jc);
+    for (int pc = 0; pc < k; pc += kKc) {
+      int kc = std::min(kKc, k - pc);
+      PackB(kc, nc, b + Offset(pc, rsb) + Offset(jc, csb), rsb, csb,
+            pack_b.data());
+      for (int ic = 0; ic < m; ic += kMc) {
+        int mc = std::min(kMc, m - ic);
+        PackA(mc, kc, a + Offset(ic, rsa) + Offset(pc, csa), rsa, csa,
+              pack_a.data());
+        for (int jr = 0; jr < nc; jr += kNr) {
+          int nr = std::min(kNr, nc - jr);
+          for (int ir = 0; ir < mc; ir += kMr) {
+            int mr = std::min(kMr, mc - ir);
+            MicroKernel(kc, pack_a.data() + Offset(ir, kc),
+                        pack_b.data() + Offset(jr, kc), tile);
+            for (int r = 0; r < mr; r++) {
+              T* crow = c + Offset(ic + ir + r, ldc) + jc + jr;
+              for (int s = 0; s < nr; s++) crow[s] += alpha * tile[r * kNr + s];
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+// Strided read-only block, the operand type of the Strassen recursion.
+template <class T>
+struct Operand {
+  const T* data;
+  int rs, cs;
+
+  [[nodiscard]] Operand Sub(int i, int j) const {
+    return {data + Offset(i, rs) + Offset(j, cs), rs, cs};
+  }
+  [[nodiscard]] const T& operator()(int i, int j) const {
+    return data[Offset(i, rs) + Offset(j, cs)];
+  }
+};
+
+// out = x + y, or x - y if sub, for m x n blocks. out may be x or y.
+template <class T>
+void AddBlocks(int m, int n, Operand<T> x, Operand<T> y, bool sub, T* out,
+               int ldo) {
+  for (int i = 0; i < m; i++) {
+    T* o = out + Offset(i, ldo);
+    if (x.cs == 1 && y.cs == 1) {
+      const T *xr = &x(i, 0), *yr = &y(i, 0);
+      if (sub)
+        for (int j = 0; j < n; j++) o[j] = xr[j] - yr[j];
+      else
+        for (int j = 0; j < n; j++) o[j] = xr[j] + yr[j];
+    } else {
+      for (int j = 0; j < n; j++)
+        o[j] = sub ? x(i, j) - y(i, j) : x(i, j) + y(i, j);
+    }
+  }
+}
+
+// C = A * B for an m x k A and a k x n B by Strassen-Winograd recursion
+// while the smallest dimension is at least `cutoff`. The 22-step schedule of
+// Boyer, Dumas, Pernet and Zhou (2009) keeps the seven products in the
+// quadrants of C and needs only two temporaries per level: X for the sums of
+// A blocks and for P1, Y for the sums of B blocks.
+template <class T>
+void Winograd(int m, int n, int k, Operand<T> a, Operand<T> b, T* c, int ldc,
+              int cutoff) {
+  if (std::min({m, n, k}) < cutoff) {
+    Gemm(m, n, k, T(1), a.data, a.rs, a.cs, b.data, b.rs, b.cs, T(0), c, ldc);
+    return;
+  }
+  int mh = m / 2, kh = k / 2, nh = n / 2;
+  Operand<T> a11 = a, a12 = a.Sub(0, kh), a21 = a.Sub(mh, 0),
+             a22 = a.Sub(mh, kh);
+  Operand<T> b11 = b, b12 = b.Sub(0, nh), b21 = b.Sub(kh, 0),
+             b22 = b.Sub(kh, nh);
+  T *c11 = c, *c12 = c + nh, *c21 = c + Offset(mh, ldc), *c22 = c21 + nh;
+  Operand<T> o11{c11, ldc, 1}, o12{c12, ldc, 1}, o21{c21, ldc, 1},
+      o22{c22, ldc, 1};
+  ScratchBuffer<T> xbuf(Offset(mh, std::max(kh, nh))), ybuf(Offset(kh, nh));
+  T *x = xbuf.data(), *y = ybuf.data();
+  Operand<T> s{x, kh, 1}, p1{x, nh, 1}, t{y, nh, 1};
+  auto mul = [&](Operand<T> l, Operand<T> r, T* out) {
+    Winograd(mh, nh, kh, l, r, out, ldc, cutoff);
+  };
+
+  AddBlocks(mh, kh, a11, a21, true, x, kh);   // S3 = A11 - A21
+  AddBlocks(kh, nh, b22, b12, true, y, nh);   // T3 = B22 - B12
+  mul(s, t, c21);                             // P7 = S3 T3
+  AddBlocks(mh, kh, a21, a22, false, x, kh);  // S1 = A21 + A22
+  AddBlocks(kh, nh, b12, b11, true, y, nh);   // T1 = B12 - B11
+  mul(s, t, c22);                             // P5 = S1 T1
+  AddBlocks(mh, kh, s, a11, true, x, kh);     // S2 = S1 - A11
+  AddBlocks(kh, nh, b22, t, true, y, nh);     // T2 = B22 - T1
+  mul(s, t, c12);                             // P6 = S2 T2
+  AddBlocks(mh, kh, a12, s, true, x, kh);     // S4 = A12 - S2
+  mul(s, b22, c11);                           // P3 = S4 B22
+  Winograd(mh, nh, kh, a11, b11, x, nh, cutoff);  // P1 = A11 B11
+  AddBlocks(mh, nh, p1, o12, false, c12, ldc);    // U2 = P1 + P6
+  AddBlocks(mh, nh, o12, o21, false, c21, ldc);   // U3 = U2 + P7
+  AddBlocks(mh, nh, o12, o22, false, c12, ldc);   // U4 = U2 + P5
+  AddBlocks(mh, nh, o21, o22, false, c22, ldc);   // U7 = U3 + P5
+  AddBlocks(mh, nh, o12, o11, false, c12, ldc);   // U5 = U4 + P3
+  AddBlocks(kh, nh, t, b21, true, y, nh);         // T4 = T2 - B21
+  mul(a22, t, c11);                               // P4 = A22 T4
+  AddBlocks(mh, nh, o21, o11, true, c21, ldc);    // U6 = U3 - P4
+  mul(a12, b21, c11);                             // P2 = A12 B21
+  AddBlocks(mh, nh, p1, o11, false, c11, ldc);    // U1 = P1 + P2
+
+  // Peel the odd row, column and inner index.
+  if (k % 2)
+    Gemm(2 * mh, 2 * nh, 1, T(1), &a(0, k - 1), a.rs, a.cs, &b(k - 1, 0), b.rs,
+         b.cs, T(1), c, ldc);
+  if (n % 2)
+    Gemm(2 * mh, 1, k, T(1), a.data, a.rs, a.cs, &b(0, n - 1), b.rs, b.cs,
+         T(0), c + n - 1, ldc);
+  if (m % 2)
+    Gemm(1, n, k, T(1), &a(m - 1, 0), a.rs, a.cs, b.data, b.rs, b.cs, T(0),
+         c + Offset(m - 1, ldc), ldc);
+}
+
+// Seconds taken by the faster of two runs of f.
+template <class F>
+double BestTime(F f) {
+  double best = 0;
+  for (int run = 0; run < 2; run++) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    std::chrono::duration<double> time =
+        std::chrono::steady_clock::now() - start;
+    if (run == 0 || time.count() < best) best = time.count();
+  }
+  return best;
+}
+
+// The smallest order n for which one level of recursion over Gemm on n / 2
+// is faster than Gemm on n.
+int CalibrateCrossover() {
+  for (int n = 2 * kMinCrossover; n <= kMaxCrossover; n *= 2) {
+    ScratchBuffer<double> a(n * n), b(n * n), c(n * n);
+    for (int i = 0; i < n * n; i++) {
+      a[i] = i % 7 - 3;
+      b[i] = i % 5 - 2;
+    }
+    double classic = BestTime([&] {
+      Gemm(n, n, n, 1.0, a.data(), n, b.data(), n, 0.0, c.data(), n);
+    });
+    double strassen = BestTime([&] {
+      Winograd<double>(n, n, n, {a.data(), n, 1}, {b.data(), n, 1}, c.data(),
+                       n, n);
+    });
+    if (strassen < classic) return n;
+  }
+  return 2 * kMaxCrossover;
+}
+
+std::atomic<int> strassen_crossover{0};
+std::mutex calibrate_mutex;
+
+}  // namespace
+
+int StrassenCrossover() {
+  int n = strassen_crossover.load(std::memory_order_acquire);
+  if (n > 0) return n;
+  std::lock_guard<std::mutex> lock(calibrate_mutex);
+  n = strassen_crossover.load(std::memory_order_relaxed);
+  if (n <= 0) {
+    n = CalibrateCrossover();
+    strassen_crossover.store(n, std::memory_order_release);
+  }
+  return n;
+}
+
+void SetStrassenCrossover(int n) {
+  strassen_crossover.store(std::max(n, 0), std::memory_order_release);
+}
+
+template <class T>
+void StrassenGemm(int m, int n, int k, T alpha, const T* a, int rsa, int csa,
+                  const T* b, int rsb, int csb, T beta, T* c, int ldc) {
+  int smallest = std::min({m, n, k});
+  bool calibrated = strassen_crossover.load(std::memory_order_acquire) > 0;
+  if (alpha == T(0) || (!calibrated && smallest < kMinCrossover) ||
+      smallest < StrassenCrossover()) {
+    Gemm(m, n, k, alpha, a, rsa, csa, b, rsb, csb, beta, c, ldc);
+    return;
+  }
+  if (alpha == T(1) && beta == T(0)) {
+    Winograd<T>(m, n, k, {a, rsa, csa}, {b, rsb, csb}, c, ldc,
+                StrassenCrossover());
+    return;
+  }
+  ScratchBuffer<T> prod(Offset(m, n));
+  Winograd<T>(m, n, k, {a, rsa, csa}, {b, rsb, csb}, prod.data(), n,
+              StrassenCrossover());
+  ScaleC(m, n, beta, c, ldc);
+  for (int i = 0; i < m; i++)
+    AxpyRow(c + Offset(i, ldc), alpha, prod.data() + Offset(i, n), n);
+}
+
+template <class T>
+void Gemm(int m, int n, int k, T alpha, const T* a, int lda, const T* b,
+          int ldb, T beta, T* c, int ldc) {
+  Gemm(m, n, k, alpha, a, lda, 1, b, ldb, 1, beta, c, ldc);
+}
+
+template <class T>
+void Gemm(int m, int n, int k, T alpha, const T* a, int rsa, int csa,
+          const T* b, int rsb, int csb, T beta, T* c, int ldc) {
+  if (m <= 0 || n <= 0) return;
+  ScaleC(m, n, beta, c, ldc);
+  if (k <= 0 || alpha == T(0)) return;
+  if (static_cast<long>(m) * n * k <= kSmallGemm) {
+    SmallGemm(m, n, k, alpha, a, rsa, csa, b, rsb, csb, c, ldc);
+    return;
+  }
+  if (Pool().size() == 1 || static_cast<long>(m) * n * k < kParallelGemm) {
+    BlockedGemm(m, n, k, alpha, a, rsa, csa, b, rsb, csb, c, ldc);
+    return;
+  }
+  // Output tiles of kMc rows by kTileCols columns are the unit of work that
+  // pool threads steal from each other.
+  int tile_rows = (m + kMc - 1) / kMc;
+  int tile_cols = (n + kTileCols - 1) / kTileCols;
+  Pool().Run(tile_rows * tile_cols, [&](int t) {
+    int i = t / tile_cols * kMc, j = t % tile_cols * kTileCols;
+    BlockedGemm(std::min(kMc, m - i), std::min(kTileCols, n - j), k, alpha,
+                a + Offset(i, rsa), rsa, csa, b + Offset(j, csb), rsb, csb,
+                c + Offset(i, ldc) + j, ldc);
+  });
+}
+
+#define S21_GEMM_INSTANTIATE(T)                                          \
+  template void Gemm<T>(int, int, int, T, const T*, int, const T*, int, T, \
+                        T*, int);                                          \
+  template void Gemm<T>(int, int, int, T, const T*, int, int, const T*,    \
+                        int, int, T, T*, int);                             \
+  template void StrassenGemm<T>(int, int, int, T, const T*, int, int,      \
+                                const T*, int, int, T, T*, int);
+S21_GEMM_INSTANTIATE(float)
+S21_GEMM_INSTANTIATE(double)
+S21_GEMM_INSTANTIATE(std::int64_t)
+S21_GEMM_INSTANTIATE(std::complex<double>)
+#undef S21_GEMM_INSTANTIATE
+
+}  // namespace s21
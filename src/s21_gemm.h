@@ -0,0 +1,41 @@
+#ifndef CPP1_S21_MATRIXPLUS_1_S21_GEMM_H
+#define CPP1_S21_MATRIXPLUS_1_S21_GEMM_H
+
+namespace s21 {
+
+// C = alpha * A * B + beta * C for row-major operands, where A is m x k,
+// B is k x n and C is m x n, with leading dimensions lda, ldb and ldc.
+// C must not alias A or B. Instantiated for float, double, std::int64_t and
+// std::complex<double>.
+template <class T>
+void Gemm(int m, int n, int k, T alpha, const T* a, int lda, const T* b,
+          int ldb, T beta, T* c, int ldc);
+
+// Same with explicit row and column strides for A and B, so transposed or
+// otherwise strided operands can be multiplied without copying them first.
+template <class T>
+void Gemm(int m, int n, int k, T alpha, const T* a, int rsa, int csa,
+          const T* b, int rsb, int csb, T beta, T* c, int ldc);
+
+// Same contract as the strided Gemm, computed by Strassen-Winograd
+// recursion: every level trades one of eight half-size products for 15 block
+// additions. Odd dimensions are peeled off and finished with Gemm, and the
+// recursion hands over to Gemm once the smallest dimension drops below
+// StrassenCrossover(). It takes O(m * n + k * (m + n)) scratch storage from
+// CurrentAllocator(). The result is exact for integers; floating-point
+// rounding differs from Gemm and the error bound grows with the depth, which
+// is why the matrix classes only take this path on request.
+template <class T>
+void StrassenGemm(int m, int n, int k, T alpha, const T* a, int rsa, int csa,
+                  const T* b, int rsb, int csb, T beta, T* c, int ldc);
+
+// Smallest dimension for which one level of recursion beats Gemm. Unless set,
+// it is measured on the first StrassenGemm call large enough to need it, by
+// timing double products of growing size both ways.
+[[nodiscard]] int StrassenCrossover();
+// Overrides the measured value; n <= 0 measures again on next use.
+void SetStrassenCrossover(int n);
+
+}  // namespace s21
+
+#endif  // CPP1_S21_MATRIXPLUS_1_S21_GEMM_H
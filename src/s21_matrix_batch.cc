@@ -0,0 +1,420 @@
+#include "s21_matrix_batch.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+#include "s21_simd.h"
+#include "s21_thread_pool.h"
+
+#if defined(__x86_64__)
+#define S21_BATCH_X86 1
+#endif
+
+namespace {
+
+template <class T>
+constexpr int kGroup = S21BasicMatrixBatch<T>::kGroup;
+
+// The lane kernels are written once over GCC vectors of kBytes and inlined
+// into one entry point per instruction set level, as in s21_simd.cc. A
+// vector holds element (i, j) of kBytes / sizeof(T) consecutive matrices, so
+// the code reads like the scalar algorithm. Vectors are only passed by
+// reference between functions.
+template <class T, int kBytes>
+struct VecOf {
+  typedef T type __attribute__((vector_size(kBytes)));
+};
+template <class T, int kBytes>
+using Vec = typename VecOf<T, kBytes>::type;
+
+template <class V, class T>
+[[gnu::always_inline]] inline V& VecAt(T* p) {
+  return *reinterpret_cast<V*>(p);
+}
+
+template <class V, class T>
+[[gnu::always_inline]] inline const V& VecAt(const T* p) {
+  return *reinterpret_cast<const V*>(p);
+}
+
+// Copies the first `count` elements of the lanes at `lane` of one group
+// into v.
+template <class V, class T>
+[[gnu::always_inline]] inline void LoadLanes(V* v, const T* group, int count,
+                                             int lane) {
+  for (int e = 0; e < count; e++)
+    v[e] = VecAt<V>(group + e * kGroup<T> + lane);
+}
+
+template <class V, class T>
+[[gnu::always_inline]] inline void StoreLanes(const V* v, T* group, int count,
+                                              int lane) {
+  for (int e = 0; e < count; e++)
+    VecAt<V>(group + e * kGroup<T> + lane) = v[e];
+}
+
+// Start of group g of a batch with `count` elements per matrix.
+template <class T>
+T* Group(T* data, int g, int count) {
+  return data + static_cast<std::size_t>(g) * count * kGroup<T>;
+}
+
+// Per-lane pivot tolerances as in S21BasicMatrix::PivotTolerances():
+// n * epsilon times the largest magnitude of each row and of each column.
+template <class T, class V>
+[[gnu::always_inline]] inline void PivotTolerances(const V* a, int n,
+                                                   V* row_tol, V* col_tol) {
+  T eps = n * std::numeric_limits<T>::epsilon();
+  for (int j = 0; j < n; j++) col_tol[j] = V{};
+  for (int i = 0; i < n; i++) {
+    V max = {};
+    for (int j = 0; j < n; j++) {
+      V x = a[i * n + j] < T(0) ? -a[i * n + j] : a[i * n + j];
+      max = x > max ? x : max;
+      col_tol[j] = x > col_tol[j] ? x : col_tol[j];
+    }
+    row_tol[i] = max * eps;
+  }
+  for (int j = 0; j < n; j++) col_tol[j] *= eps;
+}
+
+// Step k of partial pivoting on the n x n lanes in a: finds the row r >= k
+// with the largest |a(r, k)| in each lane, as S21BasicMatrix does, swaps it
+// with row k over all columns, together with its entry of row_tol, and
+// flips `sign` where rows moved. Stores the chosen row in `row` and whether
+// its pivot counts as zero, |a(r, k)| <= min(row_tol[r], col_tol[k]), in
+// `zero`.
+template <class T, class V, class M>
+[[gnu::always_inline]] inline void PivotStep(V* a, int n, int k, V* row_tol,
+                                             const V* col_tol, V& row,
+                                             M& zero, V& sign) {
+  V best = a[k * n + k] < T(0) ? -a[k * n + k] : a[k * n + k];
+  row = V{} + T(k);
+  for (int r = k + 1; r < n; r++) {
+    V x = a[r * n + k] < T(0) ? -a[r * n + k] : a[r * n + k];
+    auto larger = x > best;
+    best = larger ? x : best;
+    row = larger ? V{} + T(r) : row;
+  }
+  for (int r = k + 1; r < n; r++) {
+    auto swap = row == T(r);
+    for (int j = 0; j < n; j++) {
+      V x = a[k * n + j], y = a[r * n + j];
+      a[k * n + j] = swap ? y : x;
+      a[r * n + j] = swap ? x : y;
+    }
+    V x = row_tol[k], y = row_tol[r];
+    row_tol[k] = swap ? y : x;
+    row_tol[r] = swap ? x : y;
+    sign = swap ? -sign : sign;
+  }
+  V tol = row_tol[k] < col_tol[k] ? row_tol[k] : col_tol[k];
+  zero = best <= tol;
+}
+
+template <class T, int kBytes>
+[[gnu::always_inline]] inline void MulLanes(int m, int n, int k, const T* a,
+                                            const T* b, T* c, int begin,
+                                            int end) {
+  using V = Vec<T, kBytes>;
+  constexpr int kLanes = kBytes / sizeof(T), kVecs = kGroup<T> / kLanes;
+  // One buffer with a vector of slack between the operands: an 8 x 8 block
+  // of 64-byte vectors is exactly 4 KiB, and separate buffers would put
+  // pa, pb and pc at addresses that alias in the store-forwarding logic.
+  s21::ScratchBuffer<V> buf(m * k + k * n + m * n + 2);
+  V *pa = buf.data(), *pb = pa + m * k + 1, *pc = pb + k * n + 1;
+  for (int v = begin * kVecs; v < end * kVecs; v++) {
+    int g = v / kVecs, lane = v % kVecs * kLanes;
+    LoadLanes(pa, Group(a, g, m * k), m * k, lane);
+    LoadLanes(pb, Group(b, g, k * n), k * n, lane);
+    // The summation order of S21BasicMatrix products up to the GEMM block
+    // depth, so each lane matches the one-at-a-time result.
+    for (int i = 0; i < m; i++)
+      for (int j = 0; j < n; j++) {
+        V acc = {};
+        for (int p = 0; p < k; p++) acc += pa[i * k + p] * pb[p * n + j];
+        pc[i * n + j] = acc;
+      }
+    StoreLanes(pc, Group(c, g, m * n), m * n, lane);
+  }
+}
+
+// LU with partial pivoting; det gets one value per lane.
+template <class T, int kBytes>
+[[gnu::always_inline]] inline void DetLanes(int n, const T* a, T* det,
+                                            int begin, int end) {
+  using V = Vec<T, kBytes>;
+  constexpr int kLanes = kBytes / sizeof(T), kVecs = kGroup<T> / kLanes;
+  s21::ScratchBuffer<V> lu(n * n), tol(2 * n);
+  V *row_tol = tol.data(), *col_tol = row_tol + n;
+  for (int v = begin * kVecs; v < end * kVecs; v++) {
+    int g = v / kVecs, lane = v % kVecs * kLanes;
+    LoadLanes(lu.data(), Group(a, g, n * n), n * n, lane);
+    V row, d = V{} + T(1);
+    PivotTolerances<T>(lu.data(), n, row_tol, col_tol);
+    auto singular = d != d, zero = singular;
+    for (int k = 0; k < n; k++) {
+      PivotStep<T>(lu.data(), n, k, row_tol, col_tol, row, zero, d);
+      singular |= zero;
+      V piv = lu[k * n + k];
+      d *= piv;
+      // Singular lanes divide by one instead, to stay finite; their result
+      // is replaced below.
+      piv = zero ? V{} + T(1) : piv;
+      for (int i = k + 1; i < n; i++) {
+        V l = lu[i * n + k] / piv;
+        for (int j = k + 1; j < n; j++) lu[i * n + j] -= l * lu[k * n + j];
+      }
+    }
+    VecAt<V>(Group(det, g, 1) + lane) = singular ? V{} : d;
+  }
+}
+
+// Gauss-Jordan elimination as in S21BasicMatrix::InvertInPlace. Lanes that
+// turn out singular get 1 in `singular`, 0 otherwise.
+template <class T, int kBytes>
+[[gnu::always_inline]] inline void InvLanes(int n, const T* a, T* c,
+                                            T* singular, int begin, int end) {
+  using V = Vec<T, kBytes>;
+  constexpr int kLanes = kBytes / sizeof(T), kVecs = kGroup<T> / kLanes;
+  s21::ScratchBuffer<V> inv(n * n), perm(n), tol(2 * n);
+  V *row_tol = tol.data(), *col_tol = row_tol + n;
+  for (int v = begin * kVecs; v < end * kVecs; v++) {
+    int g = v / kVecs, lane = v % kVecs * kLanes;
+    LoadLanes(inv.data(), Group(a, g, n * n), n * n, lane);
+    V sign = {};
+    PivotTolerances<T>(inv.data(), n, row_tol, col_tol);
+    auto failed = sign != sign, zero = failed;
+    for (int k = 0; k < n; k++) {
+      PivotStep<T>(inv.data(), n, k, row_tol, col_tol, perm[k], zero, sign);
+      failed |= zero;
+      V* u = inv.data() + k * n;
+      V piv = zero ? V{} + T(1) : u[k];
+      u[k] = V{} + T(1);
+      for (int j = 0; j < n; j++) u[j] /= piv;
+      for (int i = 0; i < n; i++) {
+        if (i == k) continue;
+        V* r = inv.data() + i * n;
+        V f = r[k];
+        r[k] = V{};
+        for (int j = 0; j < n; j++) r[j] -= f * u[j];
+      }
+    }
+    // Undo the row interchanges as column interchanges, lane by lane.
+    for (int k = n - 1; k >= 0; k--)
+      for (int col = k + 1; col < n; col++) {
+        auto swap = perm[k] == T(col);
+        for (int i = 0; i < n; i++) {
+          V x = inv[i * n + k], y = inv[i * n + col];
+          inv[i * n + k] = swap ? y : x;
+          inv[i * n + col] = swap ? x : y;
+        }
+      }
+    StoreLanes(inv.data(), Group(c, g, n * n), n * n, lane);
+    VecAt<V>(Group(singular, g, 1) + lane) = failed ? V{} + T(1) : V{};
+  }
+}
+
+template <class T>
+struct BatchKernels {
+  void (*mul)(int, int, int, const T*, const T*, T*, int, int);
+  void (*det)(int, const T*, T*, int, int);
+  void (*inv)(int, const T*, T*, T*, int, int);
+};
+
+// Entry points of one instruction set level for vectors of kBytes, each
+// over the groups [begin, end).
+#define S21_BATCH_LEVEL(Level, kBytes, ...)                                  \
+  template <class T>                                                         \
+  __VA_ARGS__ void Mul##Level(int m, int n, int k, const T* a, const T* b,   \
+                              T* c, int begin, int end) {                    \
+    MulLanes<T, kBytes>(m, n, k, a, b, c, begin, end);                       \
+  }                                                                          \
+  template <class T>                                                         \
+  __VA_ARGS__ void Det##Level(int n, const T* a, T* det, int begin,          \
+                              int end) {                                     \
+    DetLanes<T, kBytes>(n, a, det, begin, end);                              \
+  }                                                                          \
+  template <class T>                                                         \
+  __VA_ARGS__ void Inv##Level(int n, const T* a, T* c, T* singular,          \
+                              int begin, int end) {                          \
+    InvLanes<T, kBytes>(n, a, c, singular, begin, end);                      \
+  }                                                                          \
+  template <class T>                                                         \
+  constexpr BatchKernels<T> k##Level{Mul##Level<T>, Det##Level<T>,           \
+                                     Inv##Level<T>};
+
+S21_BATCH_LEVEL(Scalar, sizeof(T))
+#ifdef S21_BATCH_X86
+S21_BATCH_LEVEL(Sse2, 16)
+S21_BATCH_LEVEL(Avx2, 32, __attribute__((target("avx2"))))
+S21_BATCH_LEVEL(Avx512, 64, __attribute__((target("avx512f"))))
+#endif
+#undef S21_BATCH_LEVEL
+
+template <class T>
+const BatchKernels<T>& KernelsFor(s21::SimdLevel level) {
+#ifdef S21_BATCH_X86
+  switch (level) {
+    case s21::SimdLevel::kAvx512:
+      return kAvx512<T>;
+    case s21::SimdLevel::kAvx2:
+      return kAvx2<T>;
+    case s21::SimdLevel::kSse2:
+      return kSse2<T>;
+    default:
+      break;
+  }
+#endif
+  (void)level;
+  return kScalar<T>;
+}
+
+}  // namespace
+
+template <class T>
+S21BasicMatrixBatch<T>::S21BasicMatrixBatch()
+    : size_(0), rows_(0), cols_(0), groups_(0), data_(nullptr),
+      alloc_(nullptr) {}
+
+template <class T>
+S21BasicMatrixBatch<T>::S21BasicMatrixBatch(int size, int rows, int cols)
+    : S21BasicMatrixBatch() {
+  if (size < 0 || rows < 0 || cols < 0) throw std::length_error(SIZE_MSG);
+  size_ = size;
+  rows_ = rows;
+  cols_ = cols;
+  groups_ = (size + kGroup - 1) / kGroup;
+  if (Elements() == 0) return;
+  alloc_ = &s21::CurrentAllocator();
+  data_ = static_cast<T*>(alloc_->Allocate(Elements() * sizeof(T)));
+  std::uninitialized_value_construct_n(data_, Elements());
+}
+
+template <class T>
+S21BasicMatrixBatch<T>::S21BasicMatrixBatch(const S21BasicMatrixBatch& other)
+    : S21BasicMatrixBatch(other.size_, other.rows_, other.cols_) {
+  std::copy(other.data_, other.data_ + Elements(), data_);
+}
+
+template <class T>
+S21BasicMatrixBatch<T>::S21BasicMatrixBatch(
+    S21BasicMatrixBatch&& other) noexcept
+    : size_(other.size_),
+      rows_(other.rows_),
+      cols_(other.cols_),
+      groups_(other.groups_),
+      data_(other.data_),
+      alloc_(other.alloc_) {
+  other.size_ = other.rows_ = other.cols_ = other.groups_ = 0;
+  other.data_ = nullptr;
+  other.alloc_ = nullptr;
+}
+
+template <class T>
+S21BasicMatrixBatch<T>& S21BasicMatrixBatch<T>::operator=(
+    S21BasicMatrixBatch other) noexcept {
+  std::swap(size_, other.size_);
+  std::swap(rows_, other.rows_);
+  std::swap(cols_, other.cols_);
+  std::swap(groups_, other.groups_);
+  std::swap(data_, other.data_);
+  std::swap(alloc_, other.alloc_);
+  return *this;
+}
+
+template <class T>
+S21BasicMatrixBatch<T>::~S21BasicMatrixBatch() {
+  if (data_ != nullptr) alloc_->Deallocate(data_, Elements() * sizeof(T));
+}
+
+template <class T>
+S21BasicMatrix<T> S21BasicMatrixBatch<T>::Get(int b) const {
+  if (b < 0 || b >= size_) throw std::length_error(RANGE_MSG);
+  S21BasicMatrix<T> res(rows_, cols_);
+  for (int i = 0; i < rows_; i++)
+    for (int j = 0; j < cols_; j++) res(i, j) = data_[Offset(b, i, j)];
+  return res;
+}
+
+template <class T>
+void S21BasicMatrixBatch<T>::Set(int b, const_view_type m) {
+  if (b < 0 || b >= size_) throw std::length_error(RANGE_MSG);
+  if (m.rows() != rows_ || m.cols() != cols_)
+    throw std::logic_error(CORRESPOND_MSG);
+  for (int i = 0; i < rows_; i++)
+    for (int j = 0; j < cols_; j++) data_[Offset(b, i, j)] = m(i, j);
+}
+
+template <class T>
+S21BasicMatrixBatch<T> S21BasicMatrixBatch<T>::Product(
+    const S21BasicMatrixBatch& l, const S21BasicMatrixBatch& r) {
+  if (l.data_ == nullptr || r.data_ == nullptr)
+    throw std::logic_error(EMPTY_MSG);
+  if (l.size_ != r.size_ || l.cols_ != r.rows_)
+    throw std::logic_error(CORRESPOND_MSG);
+  S21BasicMatrixBatch res(l.size_, l.rows_, r.cols_);
+  const BatchKernels<T>& kernels = KernelsFor<T>(s21::ActiveSimdLevel());
+  long cost = static_cast<long>(l.rows_) * l.cols_ * r.cols_ * kGroup;
+  s21::ParallelFor(l.groups_, cost, [&](int begin, int end) {
+    kernels.mul(l.rows_, r.cols_, l.cols_, l.data_, r.data_, res.data_, begin,
+                end);
+  });
+  return res;
+}
+
+template <class T>
+void S21BasicMatrixBatch<T>::MulMatrix(const S21BasicMatrixBatch& other) {
+  *this = Product(*this, other);
+}
+
+template <class T>
+S21BasicMatrixBatch<T> S21BasicMatrixBatch<T>::Transpose() const {
+  if (data_ == nullptr) throw std::logic_error(EMPTY_MSG);
+  S21BasicMatrixBatch res(size_, cols_, rows_);
+  // Whole element runs of a group move together.
+  for (int g = 0; g < groups_; g++)
+    for (int i = 0; i < rows_; i++)
+      for (int j = 0; j < cols_; j++)
+        std::memcpy(res.data_ + res.Offset(g * kGroup, j, i),
+                    data_ + Offset(g * kGroup, i, j), kGroup * sizeof(T));
+  return res;
+}
+
+template <class T>
+void S21BasicMatrixBatch<T>::CheckSquare() const {
+  if (data_ == nullptr) throw std::logic_error(EMPTY_MSG);
+  if (rows_ != cols_) throw std::logic_error(SQUARE_MSG);
+}
+
+template <class T>
+std::vector<T> S21BasicMatrixBatch<T>::Determinant() const {
+  CheckSquare();
+  s21::ScratchBuffer<T> det(groups_ * kGroup);
+  const BatchKernels<T>& kernels = KernelsFor<T>(s21::ActiveSimdLevel());
+  long cost = static_cast<long>(rows_) * rows_ * rows_ * kGroup;
+  s21::ParallelFor(groups_, cost, [&](int begin, int end) {
+    kernels.det(rows_, data_, det.data(), begin, end);
+  });
+  return std::vector<T>(det.data(), det.data() + size_);
+}
+
+template <class T>
+S21BasicMatrixBatch<T> S21BasicMatrixBatch<T>::InverseMatrix() const {
+  CheckSquare();
+  S21BasicMatrixBatch res(size_, rows_, cols_);
+  s21::ScratchBuffer<T> singular(groups_ * kGroup);
+  const BatchKernels<T>& kernels = KernelsFor<T>(s21::ActiveSimdLevel());
+  long cost = 2L * rows_ * rows_ * rows_ * kGroup;
+  s21::ParallelFor(groups_, cost, [&](int begin, int end) {
+    kernels.inv(rows_, data_, res.data_, singular.data(), begin, end);
+  });
+  for (int b = 0; b < size_; b++)
+    if (singular[b] != T(0)) throw std::logic_error(NULL_DET_MSG);
+  return res;
+}
+
+template class S21BasicMatrixBatch<float>;
+template class S21BasicMatrixBatch<double>;
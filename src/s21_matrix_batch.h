@@ -0,0 +1,106 @@
+#ifndef CPP1_S21_MATRIXPLUS_1_S21_MATRIX_BATCH_H
+#define CPP1_S21_MATRIXPLUS_1_S21_MATRIX_BATCH_H
+
+#include <vector>
+
+#include "s21_allocator.h"
+#include "s21_matrix_oop.h"
+
+// size() matrices of the same rows() x cols() shape in one interleaved
+// (structure-of-arrays) buffer. Matrices are grouped by kGroup, the number
+// of elements in 64 bytes; within a group, element (i, j) of all its
+// matrices is one contiguous run, and groups follow each other. So element
+// (i, j) of matrix b is
+//   data()[((b / kGroup) * rows() * cols() + i * cols() + j) * kGroup +
+//          b % kGroup],
+// and the last group is padded. The batched operations below process one
+// vector of matrices per instruction, the same arithmetic for every lane,
+// while each group stays within a few contiguous cache lines per element;
+// groups are split across the thread pool. They are meant for many small
+// matrices, where calling the S21BasicMatrix operations one by one is
+// dominated by allocation and call overhead.
+//
+// Determinants and inverses follow S21BasicMatrix: partial pivoting, with
+// a pivot treated as zero at or below n * epsilon times the largest
+// magnitude of both its row and its column. Pivots are chosen per matrix,
+// so every lane rounds exactly as it would on its own.
+// Instantiated for float and double.
+template <class T>
+class S21BasicMatrixBatch {
+  static_assert(std::is_floating_point_v<T>,
+                "batches hold float or double matrices");
+
+ public:
+  using value_type = T;
+  using const_view_type = S21BasicMatrixView<const T>;
+  static constexpr int kGroup = 64 / sizeof(T);
+
+  S21BasicMatrixBatch();
+  // size zero matrices of rows x cols.
+  S21BasicMatrixBatch(int size, int rows, int cols);
+  S21BasicMatrixBatch(const S21BasicMatrixBatch& other);
+  S21BasicMatrixBatch(S21BasicMatrixBatch&& other) noexcept;
+  S21BasicMatrixBatch& operator=(S21BasicMatrixBatch other) noexcept;
+  ~S21BasicMatrixBatch();
+
+  [[nodiscard]] int size() const { return size_; }
+  [[nodiscard]] int rows() const { return rows_; }
+  [[nodiscard]] int cols() const { return cols_; }
+  // Number of groups, size() / kGroup rounded up. The padding lanes of the
+  // last group hold unspecified values.
+  [[nodiscard]] int groups() const { return groups_; }
+  [[nodiscard]] T* data() { return data_; }
+  [[nodiscard]] const T* data() const { return data_; }
+
+  // Element (i, j) of matrix b; unchecked like S21BasicMatrix::operator().
+  T& operator()(int b, int i, int j) {
+    assert(b >= 0 && b < size_ && i >= 0 && i < rows_ && j >= 0 &&
+           j < cols_);
+    return data_[Offset(b, i, j)];
+  }
+  const T& operator()(int b, int i, int j) const {
+    assert(b >= 0 && b < size_ && i >= 0 && i < rows_ && j >= 0 &&
+           j < cols_);
+    return data_[Offset(b, i, j)];
+  }
+  // Copies matrix b out of or into the batch.
+  [[nodiscard]] S21BasicMatrix<T> Get(int b) const;
+  void Set(int b, const_view_type m);
+
+  // Matrix b of the product is l's matrix b times r's matrix b.
+  friend S21BasicMatrixBatch operator*(const S21BasicMatrixBatch& l,
+                                       const S21BasicMatrixBatch& r) {
+    return Product(l, r);
+  }
+  void MulMatrix(const S21BasicMatrixBatch& other);
+  [[nodiscard]] S21BasicMatrixBatch Transpose() const;
+  [[nodiscard]] std::vector<T> Determinant() const;
+  // Throws std::logic_error if any matrix of the batch is singular.
+  [[nodiscard]] S21BasicMatrixBatch InverseMatrix() const;
+
+ private:
+  [[nodiscard]] std::size_t Offset(int b, int i, int j) const {
+    return (static_cast<std::size_t>(b / kGroup) * rows_ * cols_ +
+            static_cast<std::size_t>(i) * cols_ + j) *
+               kGroup +
+           b % kGroup;
+  }
+  [[nodiscard]] std::size_t Elements() const {
+    return static_cast<std::size_t>(groups_) * rows_ * cols_ * kGroup;
+  }
+  static S21BasicMatrixBatch Product(const S21BasicMatrixBatch& l,
+                                     const S21BasicMatrixBatch& r);
+  void CheckSquare() const;
+
+  int size_, rows_, cols_, groups_;
+  T* data_;
+  s21::Allocator* alloc_;
+};
+
+using S21MatrixBatch = S21BasicMatrixBatch<double>;
+using S21FloatMatrixBatch = S21BasicMatrixBatch<float>;
+
+extern template class S21BasicMatrixBatch<float>;
+extern template class S21BasicMatrixBatch<double>;
+
+#endif  // CPP1_S21_MATRIXPLUS_1_S21_MATRIX_BATCH_H
@@ -0,0 +1,141 @@
+#ifndef CPP1_S21_MATRIXPLUS_1_S21_MATRIX_EXPR_H
+#define CPP1_S21_MATRIXPLUS_1_S21_MATRIX_EXPR_H
+
+#include <stdexcept>
+#include <type_traits>
+
+// Included from s21_matrix_oop.h, which provides the error messages.
+
+// Lazy element-wise expressions. operator+, operator- and scalar operator*
+// build a tree of these nodes instead of a temporary matrix per step; the
+// whole tree is then evaluated in one pass when it is assigned to (or used to
+// construct) a matrix. Shapes are checked as each node is built, so
+// errors surface at the same place as with eager operators.
+//
+// A node has the value_type of its operands, which must agree; constructing
+// a matrix from an expression of another element type converts it.
+//
+// Nodes refer to matrix operands by reference, so an expression must be
+// evaluated before the matrices it names go away; do not keep one in auto.
+//
+// Every node answers Aliases(dst): whether evaluating it straight into dst
+// could read an element after it has been overwritten. Only views laid out
+// differently from dst over the same storage can; the destination then
+// evaluates into a temporary instead.
+
+template <class T>
+class S21BasicMatrix;
+template <class T>
+class S21BasicMatrixView;
+
+template <class E>
+class S21MatrixExpr {
+ public:
+  [[nodiscard]] const E& self() const { return static_cast<const E&>(*this); }
+};
+
+namespace s21 {
+
+template <class E>
+struct IsMatrix : std::false_type {};
+template <class T>
+struct IsMatrix<S21BasicMatrix<T>> : std::true_type {};
+
+// Matrices are held by reference, intermediate nodes by value.
+template <class E>
+using ExprOperand =
+    std::conditional_t<IsMatrix<E>::value, const E&, const E>;
+
+struct AddOp {
+  template <class T>
+  static T Apply(T a, T b) {
+    return a + b;
+  }
+};
+
+struct SubOp {
+  template <class T>
+  static T Apply(T a, T b) {
+    return a - b;
+  }
+};
+
+}  // namespace s21
+
+template <class L, class R, class Op>
+class S21BinaryExpr : public S21MatrixExpr<S21BinaryExpr<L, R, Op>> {
+ public:
+  using value_type = typename L::value_type;
+  static_assert(std::is_same_v<value_type, typename R::value_type>,
+                "operands must have the same element type");
+
+  S21BinaryExpr(const L& l, const R& r) : l_(l), r_(r) {
+    if (l.rows() < 1 || l.cols() < 1 || r.rows() < 1 || r.cols() < 1)
+      throw std::logic_error(EMPTY_MSG);
+    if (l.rows() != r.rows() || l.cols() != r.cols())
+      throw std::logic_error(CORRESPOND_MSG);
+  }
+  [[nodiscard]] int rows() const { return l_.rows(); }
+  [[nodiscard]] int cols() const { return l_.cols(); }
+  [[nodiscard]] value_type At(int i, int j) const {
+    return Op::Apply(l_.At(i, j), r_.At(i, j));
+  }
+  [[nodiscard]] bool Aliases(
+      const S21BasicMatrixView<const value_type>& dst) const {
+    return l_.Aliases(dst) || r_.Aliases(dst);
+  }
+
+ private:
+  s21::ExprOperand<L> l_;
+  s21::ExprOperand<R> r_;
+};
+
+template <class E>
+class S21ScaleExpr : public S21MatrixExpr<S21ScaleExpr<E>> {
+ public:
+  using value_type = typename E::value_type;
+
+  S21ScaleExpr(const E& e, value_type num) : e_(e), num_(num) {
+    if (e.rows() < 1 || e.cols() < 1) throw std::logic_error(EMPTY_MSG);
+  }
+  [[nodiscard]] int rows() const { return e_.rows(); }
+  [[nodiscard]] int cols() const { return e_.cols(); }
+  [[nodiscard]] value_type At(int i, int j) const {
+    return e_.At(i, j) * num_;
+  }
+  [[nodiscard]] bool Aliases(
+      const S21BasicMatrixView<const value_type>& dst) const {
+    return e_.Aliases(dst);
+  }
+
+ private:
+  s21::ExprOperand<E> e_;
+  value_type num_;
+};
+
+template <class L, class R>
+S21BinaryExpr<L, R, s21::AddOp> operator+(const S21MatrixExpr<L>& l,
+                                          const S21MatrixExpr<R>& r) {
+  return {l.self(), r.self()};
+}
+
+template <class L, class R>
+S21BinaryExpr<L, R, s21::SubOp> operator-(const S21MatrixExpr<L>& l,
+                                          const S21MatrixExpr<R>& r) {
+  return {l.self(), r.self()};
+}
+
+// The scalar converts to the element type of the expression.
+template <class E>
+S21ScaleExpr<E> operator*(const S21MatrixExpr<E>& e,
+                          typename E::value_type num) {
+  return {e.self(), num};
+}
+
+template <class E>
+S21ScaleExpr<E> operator*(typename E::value_type num,
+                          const S21MatrixExpr<E>& e) {
+  return {e.self(), num};
+}
+
+#endif  // CPP1_S21_MATRIXPLUS_1_S21_MATRIX_EXPR_H
@@ -0,0 +1,465 @@
+#include "s21_matrix_io.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#include "s21_allocator.h"
+
+namespace {
+
+// Largest single read or write; Linux transfers at most about 2 GiB per
+// call.
+constexpr std::size_t kMaxTransfer = std::size_t{1} << 30;
+
+[[noreturn]] void ThrowErrno(const std::string& path) {
+  std::string what = FILE_MSG;
+  if (!path.empty()) what += " " + path;
+  throw std::system_error(errno, std::generic_category(), what);
+}
+
+int OpenFile(const std::string& path, int flags) {
+  int fd;
+  do {
+    fd = ::open(path.c_str(), flags | O_CLOEXEC, 0644);
+  } while (fd < 0 && errno == EINTR);
+  if (fd < 0) ThrowErrno(path);
+  return fd;
+}
+
+// Closes fd when the scope ends, for the error paths.
+class FdCloser {
+ public:
+  explicit FdCloser(int fd) : fd_(fd) {}
+  FdCloser(const FdCloser&) = delete;
+  FdCloser& operator=(const FdCloser&) = delete;
+  ~FdCloser() { ::close(fd_); }
+
+ private:
+  int fd_;
+};
+
+void ReadAt(int fd, void* data, std::size_t bytes, std::uint64_t offset,
+            const std::string& path) {
+  char* p = static_cast<char*>(data);
+  while (bytes > 0) {
+    ssize_t n = ::pread(fd, p, std::min(bytes, kMaxTransfer),
+                        static_cast<off_t>(offset));
+    if (n < 0 && errno == EINTR) continue;
+    if (n < 0) ThrowErrno(path);
+    if (n == 0) throw std::runtime_error(FORMAT_MSG);
+    p += n;
+    bytes -= n;
+    offset += n;
+  }
+}
+
+void WriteAt(int fd, const void* data, std::size_t bytes,
+             std::uint64_t offset, const std::string& path) {
+  const char* p = static_cast<const char*>(data);
+  while (bytes > 0) {
+    ssize_t n = ::pwrite(fd, p, std::min(bytes, kMaxTransfer),
+                         static_cast<off_t>(offset));
+    if (n < 0 && errno == EINTR) continue;
+    if (n < 0) ThrowErrno(path);
+    p += n;
+    bytes -= n;
+    offset += n;
+  }
+}
+
+// Reverses the bytes of each `unit`-byte scalar in [data, data + bytes).
+void SwapBytes(void* data, std::size_t bytes, std::size_t unit) {
+  unsigned char* p = static_cast<unsigned char*>(data);
+  for (std::size_t i = 0; i < bytes; i += unit)
+    std::reverse(p + i, p + i + unit);
+}
+
+template <class U>
+void SwapField(U& field) {
+  SwapBytes(&field, sizeof(U), sizeof(U));
+}
+
+// Size of one element of the given type, 0 for an unknown type.
+std::uint32_t ElementSize(std::uint32_t element_type) {
+  switch (static_cast<s21::ElementType>(element_type)) {
+    case s21::ElementType::kFloat:
+      return sizeof(float);
+    case s21::ElementType::kDouble:
+      return sizeof(double);
+    case s21::ElementType::kInt64:
+      return sizeof(std::int64_t);
+    case s21::ElementType::kComplexDouble:
+      return sizeof(std::complex<double>);
+  }
+  return 0;
+}
+
+// Only for headers that passed ReadHeader(), where it cannot overflow.
+std::uint64_t PayloadBytes(const s21::FileHeader& h) {
+  return static_cast<std::uint64_t>(h.rows) * h.cols * h.element_size;
+}
+
+s21::FileHeader ReadHeader(int fd, const std::string& path, bool* swapped) {
+  s21::FileHeader h;
+  ReadAt(fd, &h, sizeof(h), 0, path);
+  if (std::memcmp(h.magic, s21::kFileMagic, sizeof(h.magic)) != 0)
+    throw std::runtime_error(FORMAT_MSG);
+  bool swap = h.byte_order != s21::kByteOrderMark;
+  if (swap) {
+    SwapField(h.byte_order);
+    SwapField(h.version);
+    SwapField(h.element_type);
+    SwapField(h.element_size);
+    SwapField(h.rows);
+    SwapField(h.cols);
+    SwapField(h.payload_offset);
+    SwapField(h.alignment);
+    SwapField(h.reserved);
+  }
+  struct stat st;
+  if (::fstat(fd, &st) != 0) ThrowErrno(path);
+  if (h.byte_order != s21::kByteOrderMark || h.version < 1 ||
+      h.version > s21::kFileVersion || h.element_size == 0 ||
+      h.element_size != ElementSize(h.element_type) || h.rows < 0 ||
+      h.rows > INT_MAX || h.cols < 0 || h.cols > INT_MAX ||
+      h.alignment == 0 || h.payload_offset < sizeof(h) ||
+      h.payload_offset % h.alignment != 0)
+    throw std::runtime_error(FORMAT_MSG);
+  // A crafted size must not wrap around and pass the file size check.
+  std::uint64_t bytes, end;
+  if (__builtin_mul_overflow(static_cast<std::uint64_t>(h.rows) * h.cols,
+                             h.element_size, &bytes) ||
+      __builtin_add_overflow(h.payload_offset, bytes, &end) ||
+      static_cast<std::uint64_t>(st.st_size) < end)
+    throw std::runtime_error(FORMAT_MSG);
+  if (swapped != nullptr) *swapped = swap;
+  return h;
+}
+
+template <class T>
+s21::FileHeader ReadHeaderOf(int fd, const std::string& path,
+                             bool* swapped) {
+  s21::FileHeader h = ReadHeader(fd, path, swapped);
+  if (h.element_type !=
+          static_cast<std::uint32_t>(s21::ElementTypeOf<T>()) ||
+      h.element_size != sizeof(T))
+    throw std::runtime_error(FORMAT_MSG);
+  return h;
+}
+
+template <class T>
+s21::FileHeader MakeHeader(int rows, int cols) {
+  s21::FileHeader h{};
+  std::memcpy(h.magic, s21::kFileMagic, sizeof(h.magic));
+  h.byte_order = s21::kByteOrderMark;
+  h.version = s21::kFileVersion;
+  h.element_type = static_cast<std::uint32_t>(s21::ElementTypeOf<T>());
+  h.element_size = sizeof(T);
+  h.rows = rows;
+  h.cols = cols;
+  h.payload_offset = s21::kPayloadAlign;
+  h.alignment = s21::kPayloadAlign;
+  return h;
+}
+
+}  // namespace
+
+namespace s21 {
+
+FileHeader ReadFileHeader(const std::string& path, bool* swapped) {
+  int fd = OpenFile(path, O_RDONLY);
+  FdCloser closer(fd);
+  return ReadHeader(fd, path, swapped);
+}
+
+}  // namespace s21
+
+template <class T>
+S21MatrixWriter<T>::S21MatrixWriter(const std::string& path, int rows,
+                                    int cols)
+    : path_(path), fd_(-1), rows_(rows), cols_(cols), written_(0),
+      offset_(s21::kPayloadAlign) {
+  if (rows < 0 || cols < 0) throw std::length_error(SIZE_MSG);
+  fd_ = OpenFile(path, O_WRONLY | O_CREAT | O_TRUNC);
+}
+
+template <class T>
+S21MatrixWriter<T>::~S21MatrixWriter() {
+  if (fd_ >= 0) ::close(fd_);
+}
+
+template <class T>
+void S21MatrixWriter<T>::Write(const T* data, std::size_t count) {
+  WriteAt(fd_, data, count * sizeof(T), offset_, path_);
+  offset_ += count * sizeof(T);
+}
+
+template <class T>
+void S21MatrixWriter<T>::WriteRow(S21Span<const T> row) {
+  if (row.size() != cols_) throw std::logic_error(CORRESPOND_MSG);
+  if (written_ == rows_) throw std::logic_error(RANGE_MSG);
+  Write(row.data(), cols_);
+  written_++;
+}
+
+template <class T>
+void S21MatrixWriter<T>::WriteRows(S21BasicMatrixView<const T> rows) {
+  if (rows.cols() != cols_) throw std::logic_error(CORRESPOND_MSG);
+  if (rows.rows() > rows_ - written_) throw std::logic_error(RANGE_MSG);
+  if (rows.strided() && rows.col_stride() == 1 &&
+      rows.row_stride() == cols_) {
+    Write(rows.data(), static_cast<std::size_t>(rows.rows()) * cols_);
+    written_ += rows.rows();
+    return;
+  }
+  s21::ScratchBuffer<T> row(cols_);
+  for (int i = 0; i < rows.rows(); i++) {
+    for (int j = 0; j < cols_; j++) row[j] = rows.At(i, j);
+    WriteRow(S21Span<const T>(row.data(), cols_));
+  }
+}
+
+template <class T>
+void S21MatrixWriter<T>::Close() {
+  if (written_ != rows_) throw std::logic_error(INCOMPLETE_MSG);
+  s21::FileHeader h = MakeHeader<T>(rows_, cols_);
+  int fd = fd_;
+  fd_ = -1;
+  FdCloser closer(fd);
+  // An empty payload still has to leave the file as long as the header
+  // promises.
+  if (::ftruncate(fd, static_cast<off_t>(offset_)) != 0) ThrowErrno(path_);
+  WriteAt(fd, &h, sizeof(h), 0, path_);
+}
+
+template <class T>
+S21MappedMatrix<T>::S21MappedMatrix()
+    : map_(nullptr), map_bytes_(0), data_(nullptr), rows_(0), cols_(0),
+      writable_(false) {}
+
+template <class T>
+S21MappedMatrix<T>::S21MappedMatrix(const std::string& path, Mode mode)
+    : S21MappedMatrix() {
+  writable_ = mode == Mode::kReadWrite;
+  int fd = OpenFile(path, writable_ ? O_RDWR : O_RDONLY);
+  FdCloser closer(fd);
+  bool swapped;
+  s21::FileHeader h = ReadHeaderOf<T>(fd, path, &swapped);
+  if (swapped) throw std::runtime_error(BYTE_ORDER_MSG);
+  rows_ = static_cast<int>(h.rows);
+  cols_ = static_cast<int>(h.cols);
+  if (PayloadBytes(h) == 0) return;
+  // The mapping outlives the descriptor.
+  map_bytes_ = h.payload_offset + PayloadBytes(h);
+  map_ = ::mmap(nullptr, map_bytes_,
+                writable_ ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED,
+                fd, 0);
+  if (map_ == MAP_FAILED) {
+    map_ = nullptr;
+    ThrowErrno(path);
+  }
+  data_ = reinterpret_cast<T*>(static_cast<char*>(map_) + h.payload_offset);
+}
+
+template <class T>
+S21MappedMatrix<T>::S21MappedMatrix(S21MappedMatrix&& other) noexcept
+    : S21MappedMatrix() {
+  *this = std::move(other);
+}
+
+template <class T>
+S21MappedMatrix<T>& S21MappedMatrix<T>::operator=(
+    S21MappedMatrix&& other) noexcept {
+  if (this == &other) return *this;
+  Unmap();
+  map_ = std::exchange(other.map_, nullptr);
+  map_bytes_ = std::exchange(other.map_bytes_, 0);
+  data_ = std::exchange(other.data_, nullptr);
+  rows_ = std::exchange(other.rows_, 0);
+  cols_ = std::exchange(other.cols_, 0);
+  writable_ = std::exchange(other.writable_, false);
+  return *this;
+}
+
+template <class T>
+S21MappedMatrix<T>::~S21MappedMatrix() {
+  Unmap();
+}
+
+template <class T>
+void S21MappedMatrix<T>::Unmap() noexcept {
+  if (map_ != nullptr) ::munmap(map_, map_bytes_);
+  map_ = nullptr;
+}
+
+template <class T>
+S21BasicMatrixView<T> S21MappedMatrix<T>::MutableView() {
+  if (!writable_) throw std::logic_error(READ_ONLY_MSG);
+  return {data_, rows_, cols_, cols_, 1};
+}
+
+template <class T>
+void S21MappedMatrix<T>::Sync() {
+  if (map_ != nullptr && writable_ && ::msync(map_, map_bytes_, MS_SYNC) != 0)
+    ThrowErrno("");
+}
+
+template <class T>
+S21MatrixFile<T>::S21MatrixFile()
+    : fd_(-1), rows_(0), cols_(0), payload_offset_(0), writable_(false) {}
+
+template <class T>
+S21MatrixFile<T>::S21MatrixFile(const std::string& path, Mode mode)
+    : S21MatrixFile() {
+  path_ = path;
+  writable_ = mode == Mode::kReadWrite;
+  fd_ = OpenFile(path, writable_ ? O_RDWR : O_RDONLY);
+  bool swapped;
+  s21::FileHeader h;
+  try {
+    h = ReadHeaderOf<T>(fd_, path, &swapped);
+    if (swapped) throw std::runtime_error(BYTE_ORDER_MSG);
+  } catch (...) {
+    ::close(fd_);
+    throw;
+  }
+  rows_ = static_cast<int>(h.rows);
+  cols_ = static_cast<int>(h.cols);
+  payload_offset_ = h.payload_offset;
+}
+
+template <class T>
+S21MatrixFile<T> S21MatrixFile<T>::Create(const std::string& path, int rows,
+                                          int cols) {
+  if (rows < 0 || cols < 0) throw std::length_error(SIZE_MSG);
+  S21MatrixFile res;
+  res.path_ = path;
+  res.writable_ = true;
+  res.fd_ = OpenFile(path, O_RDWR | O_CREAT | O_TRUNC);
+  res.rows_ = rows;
+  res.cols_ = cols;
+  s21::FileHeader h = MakeHeader<T>(rows, cols);
+  res.payload_offset_ = h.payload_offset;
+  if (::ftruncate(res.fd_, static_cast<off_t>(h.payload_offset +
+                                               PayloadBytes(h))) != 0)
+    ThrowErrno(path);
+  WriteAt(res.fd_, &h, sizeof(h), 0, path);
+  return res;
+}
+
+template <class T>
+S21MatrixFile<T>::S21MatrixFile(S21MatrixFile&& other) noexcept
+    : S21MatrixFile() {
+  *this = std::move(other);
+}
+
+template <class T>
+S21MatrixFile<T>& S21MatrixFile<T>::operator=(
+    S21MatrixFile&& other) noexcept {
+  if (this == &other) return *this;
+  if (fd_ >= 0) ::close(fd_);
+  path_ = std::move(other.path_);
+  fd_ = std::exchange(other.fd_, -1);
+  rows_ = std::exchange(other.rows_, 0);
+  cols_ = std::exchange(other.cols_, 0);
+  payload_offset_ = std::exchange(other.payload_offset_, 0);
+  writable_ = std::exchange(other.writable_, false);
+  return *this;
+}
+
+template <class T>
+S21MatrixFile<T>::~S21MatrixFile() {
+  if (fd_ >= 0) ::close(fd_);
+}
+
+template <class T>
+void S21MatrixFile<T>::CheckBlock(int row, int col, int rows,
+                                  int cols) const {
+  if (row < 0 || col < 0 || rows < 0 || cols < 0 || row > rows_ - rows ||
+      col > cols_ - cols)
+    throw std::length_error(RANGE_MSG);
+}
+
+template <class T>
+std::uint64_t S21MatrixFile<T>::Offset(int row, int col) const {
+  return payload_offset_ +
+         (static_cast<std::uint64_t>(row) * cols_ + col) * sizeof(T);
+}
+
+template <class T>
+void S21MatrixFile<T>::ReadBlock(int row, int col,
+                                 S21BasicMatrixView<T> dst) const {
+  CheckBlock(row, col, dst.rows(), dst.cols());
+  if (dst.rows() == 0 || dst.cols() == 0) return;
+  std::size_t bytes = static_cast<std::size_t>(dst.cols()) * sizeof(T);
+  bool direct = dst.strided() && dst.col_stride() == 1;
+  s21::ScratchBuffer<T> buf(direct ? 0 : dst.cols());
+  for (int i = 0; i < dst.rows(); i++) {
+    T* out = direct ? &dst(i, 0) : buf.data();
+    ReadAt(fd_, out, bytes, Offset(row + i, col), path_);
+    if (!direct)
+      for (int j = 0; j < dst.cols(); j++) dst(i, j) = buf[j];
+  }
+}
+
+template <class T>
+void S21MatrixFile<T>::WriteBlock(int row, int col,
+                                  S21BasicMatrixView<const T> src) {
+  if (!writable_) throw std::logic_error(READ_ONLY_MSG);
+  CheckBlock(row, col, src.rows(), src.cols());
+  if (src.rows() == 0 || src.cols() == 0) return;
+  std::size_t bytes = static_cast<std::size_t>(src.cols()) * sizeof(T);
+  bool direct = src.strided() && src.col_stride() == 1;
+  s21::ScratchBuffer<T> buf(direct ? 0 : src.cols());
+  for (int i = 0; i < src.rows(); i++) {
+    if (!direct)
+      for (int j = 0; j < src.cols(); j++) buf[j] = src.At(i, j);
+    const T* in = direct ? &src(i, 0) : buf.data();
+    WriteAt(fd_, in, bytes, Offset(row + i, col), path_);
+  }
+}
+
+template <class T>
+void SaveMatrix(const std::string& path, S21BasicMatrixView<const T> m) {
+  S21MatrixWriter<T> writer(path, m.rows(), m.cols());
+  writer.WriteRows(m);
+  writer.Close();
+}
+
+template <class T>
+S21BasicMatrix<T> LoadMatrix(const std::string& path) {
+  int fd = OpenFile(path, O_RDONLY);
+  FdCloser closer(fd);
+  bool swapped;
+  s21::FileHeader h = ReadHeaderOf<T>(fd, path, &swapped);
+  S21BasicMatrix<T> res(static_cast<int>(h.rows), static_cast<int>(h.cols));
+  std::size_t bytes = PayloadBytes(h);
+  if (bytes == 0) return res;
+  ReadAt(fd, res.data(), bytes, h.payload_offset, path);
+  // Complex elements swap their real and imaginary parts separately.
+  if (swapped) SwapBytes(res.data(), bytes, sizeof(decltype(std::abs(T()))));
+  return res;
+}
+
+#define S21_MATRIX_IO_INSTANTIATE(T)                                      \
+  template class S21MatrixWriter<T>;                                      \
+  template class S21MappedMatrix<T>;                                      \
+  template class S21MatrixFile<T>;                                        \
+  template void SaveMatrix<T>(const std::string&,                         \
+                              S21BasicMatrixView<const T>);               \
+  template S21BasicMatrix<T> LoadMatrix<T>(const std::string&);
+S21_MATRIX_IO_INSTANTIATE(float)
+S21_MATRIX_IO_INSTANTIATE(double)
+S21_MATRIX_IO_INSTANTIATE(std::int64_t)
+S21_MATRIX_IO_INSTANTIATE(std::complex<double>)
+#undef S21_MATRIX_IO_INSTANTIATE
@@ -0,0 +1,227 @@
+#ifndef CPP1_S21_MATRIXPLUS_1_S21_MATRIX_IO_H
+#define CPP1_S21_MATRIXPLUS_1_S21_MATRIX_IO_H
+
+#include <cstdint>
+#include <string>
+
+#include "s21_matrix_oop.h"
+
+#define FILE_MSG "Cannot access the matrix file"
+#define FORMAT_MSG "Not a matrix file of this version and element type"
+#define INCOMPLETE_MSG "Not every row of the matrix file was written"
+#define READ_ONLY_MSG "Matrix file is mapped read-only"
+#define BYTE_ORDER_MSG "Matrix file has the other byte order"
+
+// Binary matrix files. A file is a 64-byte FileHeader followed, at
+// payload_offset, by the rows * cols elements in row-major order with no
+// padding. The header is stored in the byte order of the machine that wrote
+// the file, which byte_order records; payload_offset is a multiple of
+// kPayloadAlign, so a mapped payload starts on a page boundary.
+//
+// Errors from the operating system throw std::system_error; files that are
+// truncated or of another version or element type throw std::runtime_error
+// with FORMAT_MSG.
+namespace s21 {
+
+enum class ElementType : std::uint32_t {
+  kFloat = 1,
+  kDouble = 2,
+  kInt64 = 3,
+  kComplexDouble = 4,
+};
+
+template <class T>
+constexpr ElementType ElementTypeOf();
+template <>
+constexpr ElementType ElementTypeOf<float>() {
+  return ElementType::kFloat;
+}
+template <>
+constexpr ElementType ElementTypeOf<double>() {
+  return ElementType::kDouble;
+}
+template <>
+constexpr ElementType ElementTypeOf<std::int64_t>() {
+  return ElementType::kInt64;
+}
+template <>
+constexpr ElementType ElementTypeOf<std::complex<double>>() {
+  return ElementType::kComplexDouble;
+}
+
+constexpr char kFileMagic[8] = {'S', '2', '1', 'M', 'A', 'T', 'R', 'X'};
+constexpr std::uint32_t kFileVersion = 1;
+constexpr std::uint32_t kByteOrderMark = 0x01020304;
+constexpr std::uint64_t kPayloadAlign = 4096;
+
+struct FileHeader {
+  char magic[8];
+  // kByteOrderMark as written; it reads back byte-swapped on a machine of
+  // the other endianness.
+  std::uint32_t byte_order;
+  std::uint32_t version;
+  std::uint32_t element_type;
+  std::uint32_t element_size;
+  std::int64_t rows;
+  std::int64_t cols;
+  std::uint64_t payload_offset;
+  std::uint64_t alignment;
+  std::uint64_t reserved;
+};
+static_assert(sizeof(FileHeader) == 64);
+
+// Validated header of the file at path, converted to this machine's byte
+// order. swapped is set if the file has the other byte order.
+[[nodiscard]] FileHeader ReadFileHeader(const std::string& path,
+                                        bool* swapped = nullptr);
+
+}  // namespace s21
+
+// Writes a matrix file from rows supplied in order, so a matrix can be
+// stored without ever being resident. The header is written by Close(); a
+// file whose writer was destroyed before that has no valid header and
+// fails to load.
+template <class T>
+class S21MatrixWriter {
+ public:
+  // Creates or truncates path for a rows x cols matrix.
+  S21MatrixWriter(const std::string& path, int rows, int cols);
+  S21MatrixWriter(const S21MatrixWriter&) = delete;
+  S21MatrixWriter& operator=(const S21MatrixWriter&) = delete;
+  ~S21MatrixWriter();
+
+  // Appends the next rows: one row of cols() elements, or all rows of a view
+  // with cols() columns. Throws std::logic_error past the last row.
+  void WriteRow(S21Span<const T> row);
+  void WriteRows(S21BasicMatrixView<const T> rows);
+  // Writes the header and closes the file; throws std::logic_error with
+  // INCOMPLETE_MSG unless every row was written.
+  void Close();
+
+  [[nodiscard]] int rows() const { return rows_; }
+  [[nodiscard]] int cols() const { return cols_; }
+  [[nodiscard]] int rows_written() const { return written_; }
+
+ private:
+  void Write(const T* data, std::size_t count);
+
+  std::string path_;
+  int fd_;
+  int rows_, cols_, written_;
+  std::uint64_t offset_;
+};
+
+// A matrix file mapped into memory: the payload is used in place, and pages
+// are read from the file by the kernel on first access, so opening costs
+// the same for any size. Views of it behave like views of an S21Matrix.
+// Files of the other byte order cannot be mapped and throw
+// std::runtime_error with BYTE_ORDER_MSG; LoadMatrix converts them.
+template <class T>
+class S21MappedMatrix {
+ public:
+  using const_view_type = S21BasicMatrixView<const T>;
+  using view_type = S21BasicMatrixView<T>;
+  enum class Mode { kReadOnly, kReadWrite };
+
+  S21MappedMatrix();
+  // In kReadWrite mode stores through MutableView() reach the file.
+  explicit S21MappedMatrix(const std::string& path,
+                           Mode mode = Mode::kReadOnly);
+  S21MappedMatrix(S21MappedMatrix&& other) noexcept;
+  S21MappedMatrix& operator=(S21MappedMatrix&& other) noexcept;
+  ~S21MappedMatrix();
+
+  [[nodiscard]] int rows() const { return rows_; }
+  [[nodiscard]] int cols() const { return cols_; }
+  [[nodiscard]] const T* data() const { return data_; }
+  const T& operator()(int i, int j) const {
+    assert(i >= 0 && i < rows_ && j >= 0 && j < cols_);
+    return data_[static_cast<std::size_t>(i) * cols_ + j];
+  }
+  [[nodiscard]] const_view_type View() const {
+    return {data_, rows_, cols_, cols_, 1};
+  }
+  operator const_view_type() const { return View(); }
+  // Throws std::logic_error with READ_ONLY_MSG in kReadOnly mode.
+  [[nodiscard]] view_type MutableView();
+  // Writes modified pages back to the file.
+  void Sync();
+
+ private:
+  void Unmap() noexcept;
+
+  void* map_;
+  std::size_t map_bytes_;
+  T* data_;
+  int rows_, cols_;
+  bool writable_;
+};
+
+// Random-access handle on a matrix file for block-wise I/O with pread and
+// pwrite: unlike S21MappedMatrix, only the blocks being transferred are
+// resident, which is what out-of-core algorithms need. Files of the other
+// byte order throw std::runtime_error with BYTE_ORDER_MSG. Blocks may be
+// read and written from several threads at once.
+template <class T>
+class S21MatrixFile {
+ public:
+  using Mode = typename S21MappedMatrix<T>::Mode;
+
+  S21MatrixFile();
+  explicit S21MatrixFile(const std::string& path,
+                         Mode mode = Mode::kReadOnly);
+  // Creates or truncates path as a rows x cols matrix of zeros, opened for
+  // writing. The payload is not written, so on most file systems it takes no
+  // disk space until blocks are stored.
+  [[nodiscard]] static S21MatrixFile Create(const std::string& path, int rows,
+                                            int cols);
+  S21MatrixFile(S21MatrixFile&& other) noexcept;
+  S21MatrixFile& operator=(S21MatrixFile&& other) noexcept;
+  ~S21MatrixFile();
+
+  [[nodiscard]] int rows() const { return rows_; }
+  [[nodiscard]] int cols() const { return cols_; }
+  // Copies the dst.rows() x dst.cols() block at (row, col) of the file into
+  // dst, or src into the file there. Throws std::length_error for blocks
+  // outside the matrix; WriteBlock throws std::logic_error with
+  // READ_ONLY_MSG in kReadOnly mode.
+  void ReadBlock(int row, int col, S21BasicMatrixView<T> dst) const;
+  void WriteBlock(int row, int col, S21BasicMatrixView<const T> src);
+
+ private:
+  void CheckBlock(int row, int col, int rows, int cols) const;
+  [[nodiscard]] std::uint64_t Offset(int row, int col) const;
+
+  std::string path_;
+  int fd_;
+  int rows_, cols_;
+  std::uint64_t payload_offset_;
+  bool writable_;
+};
+
+// Stores m in a new file at path.
+template <class T>
+void SaveMatrix(const std::string& path, S21BasicMatrixView<const T> m);
+template <class T>
+void SaveMatrix(const std::string& path, const S21BasicMatrix<T>& m) {
+  SaveMatrix<T>(path, m.View());
+}
+// Reads a whole file into a new matrix with one bulk read, converting the
+// byte order if needed.
+template <class T>
+[[nodiscard]] S21BasicMatrix<T> LoadMatrix(const std::string& path);
+
+#define S21_MATRIX_IO_EXTERN(T)                                        \
+  extern template class S21MatrixWriter<T>;                            \
+  extern template class S21MappedMatrix<T>;                            \
+  extern template class S21MatrixFile<T>;                              \
+  extern template void SaveMatrix<T>(const std::string&,               \
+                                     S21BasicMatrixView<const T>);     \
+  extern template S21BasicMatrix<T> LoadMatrix<T>(const std::string&);
+S21_MATRIX_IO_EXTERN(float)
+S21_MATRIX_IO_EXTERN(double)
+S21_MATRIX_IO_EXTERN(std::int64_t)
+S21_MATRIX_IO_EXTERN(std::complex<double>)
+#undef S21_MATRIX_IO_EXTERN
+
+#endif  // CPP1_S21_MATRIXPLUS_1_S21_MATRIX_IO_H
@@ -1,254 +1,861 @@
 #include "s21_matrix_oop.h"
 
+#include <algorithm>
+#include <complex>
+#include <cstdint>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
 
-int S21Matrix::rows() const { return rows_; }
-int S21Matrix::cols() const { return cols_; }
-double **S21Matrix::matrix() const { return matrix_; }
+#include "s21_gemm.h"
+#include "s21_simd.h"
+#include "s21_stats.h"
 
-void S21Matrix::set_rows(int rows) {
+namespace {
+
+// x * 2^e, exact for both parts of a complex number.
+template <class T>
+T Ldexp(T x, int e) {
+  return std::ldexp(x, e);
+}
+
+template <class T>
+std::complex<T> Ldexp(std::complex<T> x, int e) {
+  return {std::ldexp(x.real(), e), std::ldexp(x.imag(), e)};
+}
+
+// Accumulates a running product as mantissa * 2^exp so that long products of
+// pivots neither overflow nor underflow before the final ldexp. The binary
+// exponent is taken from the magnitude, so complex factors scale the same way.
+template <class T>
+void ScaledProduct(T &mant, int &exp, T x) {
+  int e;
+  std::frexp(std::abs(x), &e);
+  mant *= Ldexp(x, -e);
+  exp += e;
+  std::frexp(std::abs(mant), &e);
+  mant = Ldexp(mant, -e);
+  exp += e;
+}
+
+// Returns v when a kernel can read it in place, otherwise a copy of it in
+// tmp. Minor views always need the copy, row kernels additionally need unit
+// column stride, and `conflict` marks an operand that shares storage with the
+// destination in a way the kernel cannot tolerate.
+template <class T>
+S21BasicMatrixView<const T> Direct(S21BasicMatrixView<const T> v,
+                                   bool unit_cols, bool conflict,
+                                   S21BasicMatrix<T> &tmp) {
+  if (v.strided() && (!unit_cols || v.col_stride() == 1) && !conflict)
+    return v;
+  tmp = v;
+  return tmp;
+}
+
+// Capacity for at least n when growing from capacity cap. Growth is
+// geometric, so repeated small steps copy each element O(1) times on average.
+int GrowCapacity(int cap, int n) {
+  return static_cast<int>(std::max<long>(
+      n, std::min<long>(2L * cap, std::numeric_limits<int>::max())));
+}
+
+// Panel width of the blocked LU factorization and triangular solves.
+constexpr int kLuBlock = 64;
+
+// The strided s21::Gemm or s21::StrassenGemm, as selected.
+template <class T, class... Args>
+void StridedGemm(s21::MulAlgorithm algo, Args... args) {
+  if (algo == s21::MulAlgorithm::kStrassen)
+    s21::StrassenGemm<T>(args...);
+  else
+    s21::Gemm<T>(args...);
+}
+
+}  // namespace
+
+template <class T>
+int S21BasicMatrix<T>::rows() const {
+  return rows_;
+}
+
+template <class T>
+int S21BasicMatrix<T>::cols() const {
+  return cols_;
+}
+
+template <class T>
+T **S21BasicMatrix<T>::matrix() const {
+  if (data_ == nullptr || rows_ == 0) return nullptr;
+  if (matrix_ == nullptr) {
+    matrix_ = static_cast<T **>(alloc_->Allocate(rows_ * sizeof(T *)));
+    for (int i = 0; i < rows_; i++) matrix_[i] = Row(i);
+  }
+  return matrix_;
+}
+
+template <class T>
+void S21BasicMatrix<T>::set_rows(int rows) {
   if (rows < 0) throw std::length_error(SIZE_MSG);
-  S21Matrix tmp(rows, cols_);
-  for (int i = 0; i < (rows > rows_ ? rows_ : rows); i++)
-    for (int j = 0; j < cols_; j++) tmp.matrix_[i][j] = matrix_[i][j];
-  *this = tmp;
+  if (rows > cap_rows_) Reallocate(GrowCapacity(cap_rows_, rows), ld_);
+  for (int i = rows_; i < rows; i++) std::fill(Row(i), Row(i) + cols_, T());
+  SetRowCount(rows);
 }
 
-void S21Matrix::set_cols(int cols) {
+template <class T>
+void S21BasicMatrix<T>::set_cols(int cols) {
   if (cols < 0) throw std::length_error(SIZE_MSG);
+  if (cols > ld_) Reallocate(cap_rows_, GrowCapacity(ld_, cols));
+  if (cols > cols_)
+    for (int i = 0; i < rows_; i++)
+      std::fill(Row(i) + cols_, Row(i) + cols, T());
+  cols_ = cols;
+}
 
-  S21Matrix tmp(rows_, cols);
-  for (int i = 0; i < rows_; i++)
-    for (int j = 0; j < (cols > cols_ ? cols_ : cols); j++)
-      tmp.matrix_[i][j] = matrix_[i][j];
-  *this = tmp;
+template <class T>
+void S21BasicMatrix<T>::reserve(int rows, int cols) {
+  if (rows < 0 || cols < 0) throw std::length_error(SIZE_MSG);
+  if (rows > cap_rows_ || cols > ld_)
+    Reallocate(std::max(rows, cap_rows_), std::max(cols, ld_));
+}
+
+template <class T>
+void S21BasicMatrix<T>::shrink_to_fit() {
+  if (cap_rows_ != rows_ || ld_ != cols_) Reallocate(rows_, cols_);
 }
 
-bool S21Matrix::CheckMatrix() const {
-  if (matrix_ == nullptr || rows_ < 1 || cols_ < 1) return false;
+template <class T>
+bool S21BasicMatrix<T>::CheckMatrix() const {
+  if (data_ == nullptr || rows_ < 1 || cols_ < 1) return false;
   return true;
 }
 
-void S21Matrix::RemoveMatrix() {
-  if (matrix_ != nullptr) {
-    for (int i = 0; i < rows_; i++) delete[] matrix_[i];
-    delete[] matrix_;
+template <class T>
+void S21BasicMatrix<T>::AllocMatrix(int rows, int cols) {
+  rows_ = rows;
+  cols_ = cols;
+  ld_ = cols;
+  cap_rows_ = rows;
+  matrix_ = nullptr;
+  data_ = nullptr;
+  alloc_ = nullptr;
+  std::size_t size = static_cast<std::size_t>(rows) * cols;
+  if (size == 0) return;
+  alloc_ = &s21::CurrentAllocator();
+  data_ = static_cast<T *>(alloc_->Allocate(size * sizeof(T)));
+  std::uninitialized_value_construct_n(data_, size);
+  S21_STATS_ALLOCATION(size * sizeof(T));
+}
 
-    matrix_ = nullptr;
-    rows_ = 0;
-    cols_ = 0;
-  }
+// Moves the elements into new cap_rows x ld storage, keeping the shape.
+template <class T>
+void S21BasicMatrix<T>::Reallocate(int cap_rows, int ld) {
+  S21BasicMatrix<T> tmp;
+  tmp.AllocMatrix(cap_rows, ld);
+  for (int i = 0; i < rows_; i++)
+    std::copy(Row(i), Row(i) + cols_, tmp.Row(i));
+  tmp.rows_ = rows_;
+  tmp.cols_ = cols_;
+  RemoveMatrix();
+  StealMatrix(tmp);
 }
 
-void S21Matrix::CopyMatrix(const S21Matrix &other) {
-  rows_ = other.rows_;
-  cols_ = other.cols_;
-  matrix_ = new double *[rows_]();
-  for (int i = 0; i < rows_; i++) matrix_[i] = new double[cols_]();
+// Sets rows_ within the capacity. The row pointer table is sized for
+// rows_, so a changed count drops it.
+template <class T>
+void S21BasicMatrix<T>::SetRowCount(int rows) {
+  if (rows == rows_) return;
+  if (matrix_ != nullptr) alloc_->Deallocate(matrix_, rows_ * sizeof(T *));
+  matrix_ = nullptr;
+  rows_ = rows;
+}
+
+template <class T>
+void S21BasicMatrix<T>::RemoveMatrix() {
+  if (matrix_ != nullptr) alloc_->Deallocate(matrix_, rows_ * sizeof(T *));
+  if (data_ != nullptr)
+    alloc_->Deallocate(data_,
+                       static_cast<std::size_t>(cap_rows_) * ld_ * sizeof(T));
+
+  matrix_ = nullptr;
+  data_ = nullptr;
+  alloc_ = nullptr;
+  rows_ = 0;
+  cols_ = 0;
+  ld_ = 0;
+  cap_rows_ = 0;
+}
 
+template <class T>
+void S21BasicMatrix<T>::CopyMatrix(const S21BasicMatrix<T> &other) {
+  AllocMatrix(other.rows_, other.cols_);
   for (int i = 0; i < rows_; i++)
-    for (int j = 0; j < cols_; j++) matrix_[i][j] = other.matrix_[i][j];
+    std::copy(other.Row(i), other.Row(i) + cols_, Row(i));
+  S21_STATS_COPY(static_cast<std::size_t>(rows_) * cols_ * sizeof(T));
 }
 
-S21Matrix::S21Matrix() {
+template <class T>
+void S21BasicMatrix<T>::StealMatrix(S21BasicMatrix<T> &other) noexcept {
+  rows_ = other.rows_;
+  cols_ = other.cols_;
+  ld_ = other.ld_;
+  cap_rows_ = other.cap_rows_;
+  data_ = other.data_;
+  matrix_ = other.matrix_;
+  alloc_ = other.alloc_;
+  other.rows_ = 0;
+  other.cols_ = 0;
+  other.ld_ = 0;
+  other.cap_rows_ = 0;
+  other.data_ = nullptr;
+  other.matrix_ = nullptr;
+  other.alloc_ = nullptr;
+}
+
+template <class T>
+S21BasicMatrix<T>::S21BasicMatrix() {
   rows_ = 0;
   cols_ = 0;
+  ld_ = 0;
+  cap_rows_ = 0;
+  data_ = nullptr;
   matrix_ = nullptr;
+  alloc_ = nullptr;
 }
 
-S21Matrix::S21Matrix(int rows, int cols) {
+template <class T>
+S21BasicMatrix<T>::S21BasicMatrix(int rows, int cols) {
   if (rows < 0 || cols < 0) throw std::length_error(SIZE_MSG);
-  rows_ = rows;
-  cols_ = cols;
-  matrix_ = new double *[rows_]();
-  for (int i = 0; i < rows_; i++) matrix_[i] = new double[cols_]();
+  AllocMatrix(rows, cols);
 }
 
-S21Matrix::S21Matrix(const S21Matrix &other) { CopyMatrix(other); }
-
-S21Matrix::S21Matrix(S21Matrix &&other) noexcept {
+template <class T>
+S21BasicMatrix<T>::S21BasicMatrix(const S21BasicMatrix &other) {
   CopyMatrix(other);
-  other.RemoveMatrix();
 }
 
-S21Matrix::~S21Matrix() { RemoveMatrix(); }
+template <class T>
+S21BasicMatrix<T>::S21BasicMatrix(S21BasicMatrix &&other) noexcept {
+  S21_STATS_MOVE();
+  StealMatrix(other);
+}
+
+template <class T>
+S21BasicMatrix<T>::~S21BasicMatrix() {
+  RemoveMatrix();
+}
 
-bool S21Matrix::EqMatrix(const S21Matrix &other) {
+template <class T>
+bool S21BasicMatrix<T>::EqMatrix(const S21BasicMatrix<T> &other) {
+  S21_STATS_OP(kEqMatrix, rows_, cols_);
   if (!CheckMatrix() || !other.CheckMatrix()) throw std::logic_error(EMPTY_MSG);
   if (rows_ != other.rows_ || cols_ != other.cols_) return false;
   for (int i = 0; i < rows_; i++)
-    for (int j = 0; j < cols_; j++)
-      if (round(matrix_[i][j] * pow(10, 6)) !=
-          round(other.matrix_[i][j] * pow(10, 6)))
-        return false;
+    if (!s21::EqRow(Row(i), other.Row(i), cols_)) return false;
   return true;
 }
 
-void S21Matrix::SumMatrix(const S21Matrix &other) {
-  if (!CheckMatrix() || !other.CheckMatrix()) throw std::logic_error(EMPTY_MSG);
-  if (rows_ != other.rows_ || cols_ != other.cols_)
-    throw std::logic_error(CORRESPOND_MSG);
+template <class T>
+bool S21BasicMatrix<T>::EqMatrix(const_view_type other,
+                                 s21::Tolerance tolerance) const {
+  S21_STATS_OP(kEqMatrix, rows_, cols_);
+  if (!CheckMatrix() || other.rows() < 1 || other.cols() < 1)
+    throw std::logic_error(EMPTY_MSG);
+  if (!(tolerance.value >= 0)) throw std::logic_error(TOLERANCE_MSG);
+  if (rows_ != other.rows() || cols_ != other.cols()) return false;
+  S21BasicMatrix<T> tmp;
+  const_view_type x = Direct(other, true, false, tmp);
   for (int i = 0; i < rows_; i++)
-    for (int j = 0; j < cols_; j++) matrix_[i][j] += other.matrix_[i][j];
+    if (!s21::NearRow(Row(i), &x(i, 0), cols_, tolerance)) return false;
+  return true;
 }
 
-void S21Matrix::SubMatrix(const S21Matrix &other) {
-  if (!CheckMatrix() || !other.CheckMatrix()) throw std::logic_error(EMPTY_MSG);
-  if (rows_ != other.rows_ || cols_ != other.cols_)
+template <class T>
+void S21BasicMatrix<T>::SumMatrix(const_view_type other) {
+  S21_STATS_OP(kSumMatrix, rows_, cols_);
+  if (!CheckMatrix() || other.rows() < 1 || other.cols() < 1)
+    throw std::logic_error(EMPTY_MSG);
+  if (rows_ != other.rows() || cols_ != other.cols())
     throw std::logic_error(CORRESPOND_MSG);
-  for (int i = 0; i < rows_; i++)
-    for (int j = 0; j < cols_; j++) matrix_[i][j] -= other.matrix_[i][j];
+  S21BasicMatrix<T> tmp;
+  const_view_type x = Direct(other, true, other.Aliases(*this), tmp);
+  s21::ParallelFor(rows_, cols_, [&](int begin, int end) {
+    for (int i = begin; i < end; i++) s21::AddRow(Row(i), &x(i, 0), cols_);
+  });
 }
 
-void S21Matrix::MulNumber(const double num) {
+template <class T>
+void S21BasicMatrix<T>::SubMatrix(const_view_type other) {
+  S21_STATS_OP(kSubMatrix, rows_, cols_);
+  if (!CheckMatrix() || other.rows() < 1 || other.cols() < 1)
+    throw std::logic_error(EMPTY_MSG);
+  if (rows_ != other.rows() || cols_ != other.cols())
+    throw std::logic_error(CORRESPOND_MSG);
+  S21BasicMatrix<T> tmp;
+  const_view_type x = Direct(other, true, other.Aliases(*this), tmp);
+  s21::ParallelFor(rows_, cols_, [&](int begin, int end) {
+    for (int i = begin; i < end; i++) s21::SubRow(Row(i), &x(i, 0), cols_);
+  });
+}
+
+template <class T>
+void S21BasicMatrix<T>::MulNumber(const T num) {
+  S21_STATS_OP(kMulNumber, rows_, cols_);
   if (!CheckMatrix()) throw std::logic_error(EMPTY_MSG);
-  for (int i = 0; i < rows_; i++)
-    for (int j = 0; j < cols_; j++) matrix_[i][j] *= num;
+  s21::ParallelFor(rows_, cols_, [&](int begin, int end) {
+    for (int i = begin; i < end; i++) s21::ScaleRow(Row(i), num, cols_);
+  });
 }
 
-void S21Matrix::MulMatrix(const S21Matrix &other) {
-  if (!CheckMatrix() || !other.CheckMatrix()) throw std::logic_error(EMPTY_MSG);
-  if (cols_ != other.rows_) throw std::logic_error(CORRESPOND_MSG);
-  S21Matrix res(rows_, other.cols_);
-  for (int i = 0; i < res.rows_; i++)
-    for (int j = 0; j < res.cols_; j++)
-      for (int k = 0; k < cols_; k++)
-        res(i, j) += matrix_[i][k] * other.matrix_[k][j];
-  *this = res;
+template <class T>
+void S21BasicMatrix<T>::MulMatrix(const_view_type other,
+                                  s21::MulAlgorithm algo) {
+  *this = Product(*this, other, algo);
+}
+
+// Strided views (transposes, blocks, rows and columns) go to the kernel as
+// they are; only minor views are copied.
+template <class T>
+S21BasicMatrix<T> S21BasicMatrix<T>::Product(const_view_type l,
+                                             const_view_type r,
+                                             s21::MulAlgorithm algo) {
+  S21_STATS_OP(kProduct, std::max(l.rows(), l.cols()), r.cols());
+  if (l.rows() < 1 || l.cols() < 1 || r.rows() < 1 || r.cols() < 1)
+    throw std::logic_error(EMPTY_MSG);
+  if (l.cols() != r.rows()) throw std::logic_error(CORRESPOND_MSG);
+  S21BasicMatrix<T> lt, rt, res(l.rows(), r.cols());
+  l = Direct(l, false, false, lt);
+  r = Direct(r, false, false, rt);
+  StridedGemm<T>(algo, l.rows(), r.cols(), l.cols(), 1, l.data(),
+                 l.row_stride(), l.col_stride(), r.data(), r.row_stride(),
+                 r.col_stride(), 0, res.data_, res.ld_);
+  return res;
 }
 
-S21Matrix S21Matrix::Transpose() {
+template <class T>
+void S21BasicMatrix<T>::Gemm(T alpha, const_view_type a, const_view_type b,
+                             T beta, s21::MulAlgorithm algo) {
+  S21_STATS_OP(kGemm, std::max(rows_, a.cols()), cols_);
+  if (!CheckMatrix() || a.rows() < 1 || a.cols() < 1 || b.rows() < 1 ||
+      b.cols() < 1)
+    throw std::logic_error(EMPTY_MSG);
+  if (a.cols() != b.rows() || rows_ != a.rows() || cols_ != b.cols())
+    throw std::logic_error(CORRESPOND_MSG);
+  // The kernel cannot write over its own input; only that case allocates.
+  S21BasicMatrix<T> at, bt;
+  a = Direct(a, false, a.Overlaps(*this), at);
+  b = Direct(b, false, b.Overlaps(*this), bt);
+  StridedGemm<T>(algo, rows_, cols_, a.cols(), alpha, a.data(),
+                 a.row_stride(), a.col_stride(), b.data(), b.row_stride(),
+                 b.col_stride(), beta, data_, ld_);
+}
+
+template <class T>
+void S21BasicMatrix<T>::Axpy(T alpha, const_view_type x) {
+  S21_STATS_OP(kAxpy, rows_, cols_);
+  if (!CheckMatrix() || x.rows() < 1 || x.cols() < 1)
+    throw std::logic_error(EMPTY_MSG);
+  if (rows_ != x.rows() || cols_ != x.cols())
+    throw std::logic_error(CORRESPOND_MSG);
+  S21BasicMatrix<T> tmp;
+  x = Direct(x, true, x.Aliases(*this), tmp);
+  s21::ParallelFor(rows_, cols_, [&](int begin, int end) {
+    for (int i = begin; i < end; i++)
+      s21::AxpyRow(Row(i), alpha, &x(i, 0), cols_);
+  });
+}
+
+template <class T>
+S21BasicMatrix<T> S21BasicMatrix<T>::Transpose() {
+  S21_STATS_OP(kTranspose, rows_, cols_);
   if (!CheckMatrix()) throw std::logic_error(EMPTY_MSG);
-  S21Matrix res(cols_, rows_);
-  for (int i = 0; i < rows_; i++)
-    for (int j = 0; j < cols_; j++) res(j, i) = matrix_[i][j];
+  S21BasicMatrix<T> res(cols_, rows_);
+  // Result rows are filled in bands of 32; walking the source row by row
+  // keeps the band's cache lines hot while they are written.
+  s21::ParallelFor(cols_, rows_, [&](int begin, int end) {
+    for (int band = begin; band < end; band += 32) {
+      int band_end = std::min(end, band + 32);
+      for (int i = 0; i < rows_; i++) {
+        const T *a = Row(i);
+        for (int j = band; j < band_end; j++) res.Row(j)[i] = a[j];
+      }
+    }
+  });
   return res;
 }
 
-void S21Matrix::GetCofact(S21Matrix &other, int p, int q) const {
-  int m = 0, n = 0;
+// Entries at or below this magnitude count as zero where complete pivoting
+// decides the rank of a matrix already known to be singular, so that rounding
+// noise does not masquerade as a tiny pivot.
+template <class T>
+typename S21BasicMatrix<T>::Real S21BasicMatrix<T>::SingularTolerance() const {
+  Real max = 0;
   for (int i = 0; i < rows_; i++) {
-    if (i == p) continue;
-    m = 0;
-    for (int j = 0; j < cols_; j++) {
-      if (j == q) continue;
-      other(n, m) = matrix_[i][j];
-      m++;
+    const T *a = Row(i);
+    for (int j = 0; j < cols_; j++) max = std::max(max, std::abs(a[j]));
+  }
+  return rows_ * std::numeric_limits<Real>::epsilon() * max;
+}
+
+// Per-row and per-column noise levels for the zero-pivot test of partial
+// pivoting: n * epsilon times the largest magnitude in the row or column. A
+// pivot counts as zero only if it is within the noise of both its original
+// row and its column, so scaling rows or columns by any factor, as in
+// diag(1e-20, 1), does not turn an invertible matrix singular.
+template <class T>
+void S21BasicMatrix<T>::PivotTolerances(Real *row_tol, Real *col_tol) const {
+  int n = rows_;
+  Real eps = n * std::numeric_limits<Real>::epsilon();
+  std::fill(col_tol, col_tol + n, Real(0));
+  for (int i = 0; i < n; i++) {
+    const T *a = Row(i);
+    Real max = 0;
+    for (int j = 0; j < n; j++) {
+      Real m = std::abs(a[j]);
+      max = std::max(max, m);
+      col_tol[j] = std::max(col_tol[j], m);
     }
-    n++;
+    row_tol[i] = eps * max;
   }
+  for (int j = 0; j < n; j++) col_tol[j] *= eps;
 }
 
-double S21Matrix::GetDeterminant() {
-  if (rows_ == 1) return matrix_[0][0];
-  S21Matrix tmp(rows_ - 1, cols_ - 1);
-  int sign = 1;
-  double res = 0;
-  for (int i = 0; i < rows_; i++) {
-    GetCofact(tmp, 0, i);
-    res += sign * matrix_[0][i] * tmp.GetDeterminant();
-    sign *= -1;
+// In-place LU with partial pivoting: U ends up on and above the diagonal,
+// the multipliers of the unit lower triangle L below it. perm[k] records the
+// row swapped with row k at step k. Returns the sign of the permutation, or 0
+// at the first pivot that counts as zero by PivotTolerances().
+//
+// Right-looking and blocked: each panel of kLuBlock columns is eliminated
+// one column at a time, then the rows of U to its right are finished by a
+// triangular solve and the trailing matrix takes the panel's update as one
+// Gemm, which is where almost all of the work goes for large matrices. A
+// matrix within one panel is factored exactly as by unblocked elimination.
+template <class T>
+int S21BasicMatrix<T>::LuDecompose(int *perm) {
+  int n = rows_, sign = 1;
+  s21::ScratchBuffer<Real> row_tol(n), col_tol(n);
+  PivotTolerances(row_tol.data(), col_tol.data());
+  for (int k0 = 0; k0 < n; k0 += kLuBlock) {
+    int k1 = std::min(n, k0 + kLuBlock);
+    for (int k = k0; k < k1; k++) {
+      int p = k;
+      for (int i = k + 1; i < n; i++)
+        if (std::abs(Row(i)[k]) > std::abs(Row(p)[k])) p = i;
+      perm[k] = p;
+      Real mag = std::abs(Row(p)[k]);
+      if (mag <= std::min(row_tol[p], col_tol[k])) return 0;
+      if (p != k) {
+        std::swap_ranges(Row(k), Row(k) + n, Row(p));
+        std::swap(row_tol[k], row_tol[p]);
+        sign = -sign;
+      }
+      const T *u = Row(k);
+      for (int i = k + 1; i < n; i++) {
+        T *a = Row(i);
+        T l = a[k] /= u[k];
+        s21::AxpyRow(a + k + 1, -l, u + k + 1, k1 - k - 1);
+      }
+    }
+    if (k1 == n) break;
+    // U12 = L11^-1 * A12, then A22 -= L21 * U12.
+    for (int k = k0; k < k1; k++)
+      for (int i = k + 1; i < k1; i++)
+        s21::AxpyRow(Row(i) + k1, -Row(i)[k], Row(k) + k1, n - k1);
+    s21::Gemm<T>(n - k1, n - k1, k1 - k0, T(-1), Row(k1) + k0, ld_,
+                 Row(k0) + k1, ld_, T(1), Row(k1) + k1, ld_);
   }
-  return res;
+  return sign;
+}
+
+// Overwrites the n x m row-major block b, with leading dimension ldb, by the
+// solution of A * X = b, where *this holds the LuDecompose() factors of A and
+// perm its row interchanges. Blocked like LuDecompose(): rows inside each
+// diagonal block of L or U are eliminated against each other, and the rest
+// of b takes the block's contribution as one Gemm.
+template <class T>
+void S21BasicMatrix<T>::LuSolve(const int *perm, T *b, int ldb, int m) const {
+  int n = rows_;
+  auto brow = [b, ldb](int i) { return b + static_cast<std::size_t>(i) * ldb; };
+  for (int k = 0; k < n; k++)
+    if (perm[k] != k) std::swap_ranges(brow(k), brow(k) + m, brow(perm[k]));
+  // L * Y = P * b, top down.
+  for (int k0 = 0; k0 < n; k0 += kLuBlock) {
+    int k1 = std::min(n, k0 + kLuBlock);
+    for (int k = k0; k < k1; k++)
+      for (int i = k + 1; i < k1; i++)
+        s21::AxpyRow(brow(i), -Row(i)[k], brow(k), m);
+    if (k1 < n)
+      s21::Gemm<T>(n - k1, m, k1 - k0, T(-1), Row(k1) + k0, ld_, brow(k0),
+                   ldb, T(1), brow(k1), ldb);
+  }
+  // U * X = Y, bottom up.
+  for (int k1 = n; k1 > 0; k1 -= kLuBlock) {
+    int k0 = std::max(0, k1 - kLuBlock);
+    for (int k = k1 - 1; k >= k0; k--) {
+      T *x = brow(k), d = Row(k)[k];
+      for (int j = 0; j < m; j++) x[j] /= d;
+      for (int i = k0; i < k; i++) s21::AxpyRow(brow(i), -Row(i)[k], x, m);
+    }
+    if (k0 > 0)
+      s21::Gemm<T>(k0, m, k1 - k0, T(-1), Row(0) + k0, ld_, brow(k0), ldb,
+                   T(1), b, ldb);
+  }
+}
+
+// Gauss-Jordan elimination with partial pivoting that overwrites the matrix
+// with its inverse. Row interchanges are undone as column interchanges at the
+// end, so no second buffer is needed. Returns false for a singular matrix,
+// by the pivot test of PivotTolerances(); otherwise stores the determinant
+// of the original matrix in *det if given.
+template <class T>
+bool S21BasicMatrix<T>::InvertInPlace(T *det) {
+  int n = rows_, sign = 1, exp = 0;
+  T mant = 1;
+  s21::ScratchBuffer<int> perm(n);
+  s21::ScratchBuffer<Real> row_tol(n), col_tol(n);
+  PivotTolerances(row_tol.data(), col_tol.data());
+  for (int k = 0; k < n; k++) {
+    int p = k;
+    for (int i = k + 1; i < n; i++)
+      if (std::abs(Row(i)[k]) > std::abs(Row(p)[k])) p = i;
+    Real mag = std::abs(Row(p)[k]);
+    if (mag <= std::min(row_tol[p], col_tol[k])) return false;
+    perm[k] = p;
+    if (p != k) {
+      std::swap_ranges(Row(k), Row(k) + n, Row(p));
+      std::swap(row_tol[k], row_tol[p]);
+      sign = -sign;
+    }
+    T *u = Row(k);
+    T piv = u[k];
+    ScaledProduct(mant, exp, piv);
+    u[k] = 1;
+    for (int j = 0; j < n; j++) u[j] /= piv;
+    for (int i = 0; i < n; i++) {
+      T *a = Row(i);
+      T f = a[k];
+      if (i == k || f == T(0)) continue;
+      a[k] = 0;
+      for (int j = 0; j < n; j++) a[j] -= f * u[j];
+    }
+  }
+  for (int k = n - 1; k >= 0; k--)
+    if (perm[k] != k)
+      for (int i = 0; i < n; i++) std::swap(Row(i)[k], Row(i)[perm[k]]);
+  if (det != nullptr) *det = Ldexp(T(sign) * mant, exp);
+  return true;
+}
+
+// In-place LU with complete pivoting, which reveals the numerical rank: the
+// elimination stops once every remaining entry is below SingularTolerance().
+// row_perm[k] / col_perm[k] record the row and column swapped into position
+// k at step k. Returns the rank.
+template <class T>
+int S21BasicMatrix<T>::FullPivotLu(int *row_perm, int *col_perm) {
+  int n = rows_;
+  Real tol = SingularTolerance();
+  for (int k = 0; k < n; k++) {
+    int p = k, q = k;
+    Real max = 0;
+    for (int i = k; i < n; i++)
+      for (int j = k; j < n; j++)
+        if (std::abs(Row(i)[j]) > max) {
+          max = std::abs(Row(i)[j]);
+          p = i;
+          q = j;
+        }
+    row_perm[k] = p;
+    col_perm[k] = q;
+    if (max <= tol) return k;
+    if (p != k) std::swap_ranges(Row(k), Row(k) + n, Row(p));
+    if (q != k)
+      for (int i = 0; i < n; i++) std::swap(Row(i)[k], Row(i)[q]);
+    const T *u = Row(k);
+    for (int i = k + 1; i < n; i++) {
+      T *a = Row(i);
+      T l = a[k] /= u[k];
+      for (int j = k + 1; j < n; j++) a[j] -= l * u[j];
+    }
+  }
+  return n;
 }
 
-S21Matrix S21Matrix::CalcComplements() {
+// Numerical rank of a square matrix by complete pivoting. If it is n - 1,
+// stores a right null vector in z[0..n); otherwise z is left unspecified.
+template <class T>
+int S21BasicMatrix<T>::NullVector(T *z) const {
+  int n = rows_;
+  S21BasicMatrix<T> lu(*this);
+  s21::ScratchBuffer<int> row_perm(n), col_perm(n);
+  int rank = lu.FullPivotLu(row_perm.data(), col_perm.data());
+  if (rank != n - 1) return rank;
+  // Back substitution on U z = 0 with z[n - 1] = 1, then undo the column
+  // interchanges in reverse order.
+  z[n - 1] = 1;
+  for (int k = n - 2; k >= 0; k--) {
+    const T *u = lu.Row(k);
+    T sum = 0;
+    for (int m = k + 1; m < n; m++) sum += u[m] * z[m];
+    z[k] = -sum / u[k];
+  }
+  for (int k = n - 1; k >= 0; k--) std::swap(z[k], z[col_perm[k]]);
+  return rank;
+}
+
+// Cofactors of a matrix that partial pivoting found singular. With rank
+// below n - 1 every minor of order n - 1 vanishes. With rank n - 1 the
+// adjugate is the rank-one matrix alpha * x * y^T, where A x = 0 and
+// y^T A = 0; alpha is recovered from a single minor chosen where x and y are
+// largest. Complete pivoting may still find full rank on a borderline
+// matrix, and then there are no null vectors to use: every cofactor is
+// evaluated directly instead.
+template <class T>
+void S21BasicMatrix<T>::SingularComplements(S21BasicMatrix<T> &res) const {
+  int n = rows_;
+  s21::ScratchBuffer<T> x(n), y(n);
+  S21BasicMatrix<T> trans(n, n);
+  for (int i = 0; i < n; i++)
+    for (int j = 0; j < n; j++) trans.Row(j)[i] = Row(i)[j];
+  int rank = NullVector(x.data());
+  if (rank == n - 1) rank = trans.NullVector(y.data());
+  if (rank < n - 1) return;
+  if (rank == n) {
+    MinorComplements(res);
+    return;
+  }
+  int i = 0, j = 0;
+  for (int k = 1; k < n; k++) {
+    if (std::abs(x[k]) > std::abs(x[i])) i = k;
+    if (std::abs(y[k]) > std::abs(y[j])) j = k;
+  }
+  // adj(A)(i, j) is the cofactor of element (j, i).
+  S21BasicMatrix<T> minor = MinorView(j, i);
+  T adj = T((i + j) % 2 ? -1 : 1) * minor.DeterminantInPlace();
+  T alpha = adj / (x[i] * y[j]);
+  for (int r = 0; r < n; r++) {
+    T *c = res.Row(r);
+    for (int s = 0; s < n; s++) c[s] = alpha * y[r] * x[s];
+  }
+}
+
+// Complements each from the determinant of its minor. This costs O(n^5),
+// but for integers stays exact where det(A) * A^-1 would not.
+template <class T>
+void S21BasicMatrix<T>::MinorComplements(S21BasicMatrix &res) const {
+  int n = rows_;
+  s21::ParallelFor(n, static_cast<long>(n) * n * n * n, [&](int begin,
+                                                            int end) {
+    S21BasicMatrix minor(n - 1, n - 1);
+    for (int i = begin; i < end; i++)
+      for (int j = 0; j < n; j++) {
+        minor = MinorView(i, j);
+        res.Row(i)[j] = T((i + j) % 2 ? -1 : 1) * minor.DeterminantInPlace();
+      }
+  });
+}
+
+// Fraction-free Gaussian elimination (Bareiss): every division is exact, so
+// integer determinants come out exact as long as the intermediate minors fit
+// in T. Overwrites *this.
+template <class T>
+T S21BasicMatrix<T>::BareissDeterminant() {
+  int n = rows_;
+  T sign = 1, prev = 1;
+  for (int k = 0; k < n - 1; k++) {
+    int p = k;
+    while (p < n && Row(p)[k] == T(0)) p++;
+    if (p == n) return 0;
+    if (p != k) {
+      std::swap_ranges(Row(k), Row(k) + n, Row(p));
+      sign = -sign;
+    }
+    const T *u = Row(k);
+    for (int i = k + 1; i < n; i++) {
+      T *a = Row(i);
+      for (int j = k + 1; j < n; j++) a[j] = (a[j] * u[k] - a[k] * u[j]) / prev;
+    }
+    prev = u[k];
+  }
+  return sign * Row(n - 1)[n - 1];
+}
+
+// Determinant of a square matrix, overwriting *this with its factors.
+template <class T>
+T S21BasicMatrix<T>::DeterminantInPlace() {
+  if constexpr (std::is_integral_v<T>) {
+    return BareissDeterminant();
+  } else {
+    s21::ScratchBuffer<int> perm(rows_);
+    int sign = LuDecompose(perm.data());
+    if (sign == 0) return 0;
+    T mant = sign;
+    int exp = 0;
+    for (int k = 0; k < rows_; k++) ScaledProduct(mant, exp, Row(k)[k]);
+    return Ldexp(mant, exp);
+  }
+}
+
+// Cofactors from one factorization: C = det(A) * (A^-1)^T for an invertible
+// matrix, with a rank-revealing fallback for singular ones.
+template <class T>
+S21BasicMatrix<T> S21BasicMatrix<T>::CalcComplements() {
+  S21_STATS_OP(kCalcComplements, rows_, cols_);
   if (!CheckMatrix()) throw std::logic_error(EMPTY_MSG);
   if (rows_ != cols_) throw std::logic_error(SQUARE_MSG);
-  S21Matrix res(rows_, cols_);
-  if (rows_ == 1)
-    res(0, 0) = matrix_[0][0];
-  else {
-    for (int i = 0; i < rows_; i++)
-      for (int j = 0; j < cols_; j++) {
-        S21Matrix minor(rows_ - 1, cols_ - 1);
-        GetCofact(minor, i, j);
-        res(i, j) = pow(-1., i + j) * minor.GetDeterminant();
+  if (rows_ == 1) return *this;
+  S21BasicMatrix<T> res(*this);
+  T det;
+  if constexpr (std::is_integral_v<T>) {
+    MinorComplements(res);
+  } else if (res.InvertInPlace(&det)) {
+    for (int i = 0; i < rows_; i++) {
+      T *a = res.Row(i);
+      a[i] *= det;
+      for (int j = i + 1; j < cols_; j++) {
+        T &b = res.Row(j)[i];
+        std::swap(a[j], b);
+        a[j] *= det;
+        b *= det;
       }
+    }
+  } else {
+    std::fill(res.data_, res.data_ + static_cast<std::size_t>(rows_) * ld_,
+              T(0));
+    SingularComplements(res);
   }
   return res;
 }
 
-double S21Matrix::Determinant() {
+template <class T>
+T S21BasicMatrix<T>::Determinant() {
+  S21_STATS_OP(kDeterminant, rows_, cols_);
   if (!CheckMatrix()) throw std::logic_error(EMPTY_MSG);
   if (rows_ != cols_) throw std::logic_error(SQUARE_MSG);
-  return GetDeterminant();
+  S21BasicMatrix<T> lu(*this);
+  return lu.DeterminantInPlace();
 }
 
-S21Matrix S21Matrix::InverseMatrix() {
-  double det = Determinant();
-  if (det == 0) throw std::logic_error(NULL_DET_MSG);
-  S21Matrix tmp = CalcComplements();
-  if (rows_ == 1)
-    tmp(0, 0) = 1 / det;
-  else {
-    tmp = tmp.Transpose();
-    tmp.MulNumber(1 / det);
-  }
-  return tmp;
+template <class T>
+S21BasicMatrix<T> S21BasicMatrix<T>::InverseMatrix() {
+  S21_STATS_OP(kInverseMatrix, rows_, cols_);
+  if (!CheckMatrix()) throw std::logic_error(EMPTY_MSG);
+  if (rows_ != cols_) throw std::logic_error(SQUARE_MSG);
+  if (std::is_integral_v<T>) throw std::logic_error(INTEGER_MSG);
+  S21BasicMatrix<T> res(*this);
+  if (!res.InvertInPlace()) throw std::logic_error(NULL_DET_MSG);
+  return res;
 }
 
-S21Matrix S21Matrix::operator+(const S21Matrix &other) {
-  S21Matrix res(*this);
-  res.SumMatrix(other);
+template <class T>
+S21BasicMatrix<T> S21BasicMatrix<T>::Solve(const_view_type b) const {
+  S21BasicMatrix<T> res(b);
+  SolveInPlace(res.View());
   return res;
 }
 
-S21Matrix S21Matrix::operator-(const S21Matrix &other) {
-  S21Matrix res(*this);
-  res.SubMatrix(other);
-  return res;
+template <class T>
+void S21BasicMatrix<T>::SolveInPlace(view_type b) const {
+  S21_STATS_OP(kSolve, rows_, b.cols());
+  if (!CheckMatrix()) throw std::logic_error(EMPTY_MSG);
+  if (rows_ != cols_) throw std::logic_error(SQUARE_MSG);
+  if (std::is_integral_v<T>) throw std::logic_error(INTEGER_MSG);
+  if (b.rows() != rows_) throw std::logic_error(CORRESPOND_MSG);
+  // Factors a copy, so b may share storage with *this.
+  S21BasicMatrix<T> lu(*this);
+  s21::ScratchBuffer<int> perm(rows_);
+  if (lu.LuDecompose(perm.data()) == 0) throw std::logic_error(NULL_DET_MSG);
+  if (b.cols() == 0) return;
+  if (b.strided() && b.col_stride() == 1) {
+    lu.LuSolve(perm.data(), b.data(), b.row_stride(), b.cols());
+  } else {
+    S21BasicMatrix<T> x(b);
+    lu.LuSolve(perm.data(), x.data_, x.ld_, x.cols_);
+    b.Assign(x.View());
+  }
 }
 
-S21Matrix S21Matrix::operator*(const double num) {
-  S21Matrix res(*this);
-  res.MulNumber(num);
-  return res;
+template <class T>
+void S21BasicMatrix<T>::SolveInPlace(S21Span<T> x) const {
+  SolveInPlace(view_type(x.data(), x.size(), 1, 1, 1));
 }
 
-S21Matrix S21Matrix::operator*(const S21Matrix &other) {
-  S21Matrix res(*this);
-  res.MulMatrix(other);
-  return res;
+template <class T>
+bool S21BasicMatrix<T>::operator==(const S21BasicMatrix<T> &other) {
+  return EqMatrix(other);
 }
 
-bool S21Matrix::operator==(const S21Matrix &other) { return EqMatrix(other); }
+template <class T>
+S21BasicMatrix<T> &S21BasicMatrix<T>::operator=(
+    const S21BasicMatrix<T> &other) {
+  if (this == &other) return *this;
+  if (data_ != nullptr && other.rows_ <= cap_rows_ && other.cols_ <= ld_) {
+    // Fits the capacity: overwrite the existing buffer instead of
+    // reallocating.
+    SetRowCount(other.rows_);
+    cols_ = other.cols_;
+    for (int i = 0; i < rows_; i++)
+      std::copy(other.Row(i), other.Row(i) + cols_, Row(i));
+    S21_STATS_COPY(static_cast<std::size_t>(rows_) * cols_ * sizeof(T));
+    return *this;
+  }
+  S21BasicMatrix<T> tmp(other);
+  RemoveMatrix();
+  StealMatrix(tmp);
+  return *this;
+}
 
-S21Matrix &S21Matrix::operator=(const S21Matrix &other) {
-  S21Matrix tmp(other);
+template <class T>
+S21BasicMatrix<T> &S21BasicMatrix<T>::operator=(
+    S21BasicMatrix<T> &&other) noexcept {
+  if (this == &other) return *this;
+  S21_STATS_MOVE();
   RemoveMatrix();
-  CopyMatrix(tmp);
+  StealMatrix(other);
   return *this;
 }
 
-S21Matrix S21Matrix::operator+=(const S21Matrix &other) {
+template <class T>
+S21BasicMatrix<T> &S21BasicMatrix<T>::operator+=(
+    const S21BasicMatrix<T> &other) {
   this->SumMatrix(other);
   return *this;
 }
 
-S21Matrix S21Matrix::operator-=(const S21Matrix &other) {
+template <class T>
+S21BasicMatrix<T> &S21BasicMatrix<T>::operator-=(
+    const S21BasicMatrix<T> &other) {
   this->SubMatrix(other);
   return *this;
 }
 
-S21Matrix S21Matrix::operator*=(const double num) {
+template <class T>
+S21BasicMatrix<T> &S21BasicMatrix<T>::operator*=(const T num) {
   this->MulNumber(num);
   return *this;
 }
 
-S21Matrix S21Matrix::operator*=(const S21Matrix &other) {
+template <class T>
+S21BasicMatrix<T> &S21BasicMatrix<T>::operator*=(const_view_type other) {
   this->MulMatrix(other);
   return *this;
 }
 
-double &S21Matrix::operator()(int i, int j) {
+template <class T>
+T &S21BasicMatrix<T>::at(int i, int j) {
   if (i >= rows_ || j >= cols_ || i < 0 || j < 0)
-    throw std::length_error("Indices outside the range");
-  return matrix_[i][j];
+    throw std::length_error(RANGE_MSG);
+  return Row(i)[j];
 }
 
-double &S21Matrix::operator()(int i, int j) const {
+template <class T>
+const T &S21BasicMatrix<T>::at(int i, int j) const {
   if (i >= rows_ || j >= cols_ || i < 0 || j < 0)
-    throw std::length_error("Indices outside the range");
-  return matrix_[i][j];
-}
\ No newline at end of file
+    throw std::length_error(RANGE_MSG);
+  return Row(i)[j];
+}
+
+template class S21BasicMatrix<float>;
+template class S21BasicMatrix<double>;
+template class S21BasicMatrix<std::int64_t>;
+template class S21BasicMatrix<std::complex<double>>;
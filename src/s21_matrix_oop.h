@@ -1,61 +1,352 @@
 #ifndef CPP1_S21_MATRIXPLUS_1_S21_MATRIX_OOP_H
 #define CPP1_S21_MATRIXPLUS_1_S21_MATRIX_OOP_H
 
+#include <cassert>
 #include <cmath>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
+#include <type_traits>
+#include <vector>
 
 #define SIZE_MSG "Matrix size must be greater or equal to zero"
 #define CORRESPOND_MSG "Matrices sizes don't correspond"
 #define SQUARE_MSG "Matrix is not square"
 #define NULL_DET_MSG "Matrix's determinant is zero"
 #define EMPTY_MSG "Matrix is empty"
+#define RANGE_MSG "Indices outside the range"
+#define MINOR_MSG "Nested minor views are not supported"
+#define INTEGER_MSG "Integer matrices have no integer inverse"
+#define TOLERANCE_MSG "Tolerance must not be negative"
+
+#include "s21_allocator.h"
+#include "s21_matrix_expr.h"
+#include "s21_matrix_view.h"
+#include "s21_simd.h"
+#include "s21_stats.h"
+#include "s21_thread_pool.h"
+
+namespace s21 {
+
+// How MulMatrix and Gemm multiply. kStrassen uses s21::StrassenGemm for
+// products above the calibrated crossover; it is faster on large products
+// but rounds differently from kClassic, so it is chosen per call.
+enum class MulAlgorithm { kClassic, kStrassen };
+
+}  // namespace s21
+
+// Non-owning view of n consecutive elements, e.g. one matrix row.
+template <class T>
+class S21Span {
+ public:
+  S21Span(T* data, int size) : data_(data), size_(size) {}
+  // Writable spans convert to read-only ones.
+  template <class U, class = std::enable_if_t<std::is_same_v<const U, T> &&
+                                              !std::is_same_v<U, T>>>
+  S21Span(const S21Span<U>& other)
+      : data_(other.data()), size_(other.size()) {}
+  [[nodiscard]] T* data() const { return data_; }
+  [[nodiscard]] int size() const { return size_; }
+  [[nodiscard]] T* begin() const { return data_; }
+  [[nodiscard]] T* end() const { return data_ + size_; }
+  T& operator[](int i) const {
+    assert(i >= 0 && i < size_);
+    return data_[i];
+  }
+
+ private:
+  T* data_;
+  int size_;
+};
+
+// Dense matrix of float, double, std::int64_t or std::complex<double>
+// elements; S21Matrix is the double one. The member functions are compiled
+// once per element type in s21_matrix_oop.cc.
+//
+// Per element type: EqMatrix uses the rule of the matching s21::EqRow
+// overload (see s21_simd.h), or s21::NearRow when given an s21::Tolerance.
+// Integer determinants and complements are exact,
+// by fraction-free elimination, as long as intermediate values fit in
+// 64 bits; InverseMatrix and Solve of an integer matrix throw.
+//
+// Storage, including the scratch space of decompositions, comes from
+// s21::CurrentAllocator() at the time the matrix is created or its storage
+// grows (see s21_allocator.h).
+template <class T>
+class S21BasicMatrix : public S21MatrixExpr<S21BasicMatrix<T>> {
+ public:
+  using value_type = T;
+  using view_type = S21BasicMatrixView<T>;
+  using const_view_type = S21BasicMatrixView<const T>;
 
-class S21Matrix {
  private:
+  // Magnitude type, e.g. of pivots: double for std::complex<double>.
+  using Real = decltype(std::abs(T()));
+
   int rows_, cols_;
-  double** matrix_;
+  // Elements live in one contiguous row-major block: (i, j) is stored at
+  // data_[i * ld_ + j]. The block holds cap_rows_ rows of ld_ elements, so
+  // the shape can change in place within that capacity; elements outside
+  // rows_ x cols_ are unspecified.
+  int ld_, cap_rows_;
+  T* data_;
+  // Row pointer table over data_ for matrix() callers, built on first use.
+  mutable T** matrix_;
+  // Where data_ and matrix_ came from; null while data_ is.
+  s21::Allocator* alloc_;
+  [[nodiscard]] T* Row(int i) const {
+    return data_ + static_cast<std::size_t>(i) * ld_;
+  }
+  [[nodiscard]] T At(int i, int j) const { return Row(i)[j]; }
+  [[nodiscard]] bool Aliases(const const_view_type&) const { return false; }
+  template <class E>
+  void EvalExpr(const E& expr);
+  static S21BasicMatrix Product(
+      const_view_type l, const_view_type r,
+      s21::MulAlgorithm algo = s21::MulAlgorithm::kClassic);
+  template <class L, class R, class Op>
+  friend class S21BinaryExpr;
+  template <class E>
+  friend class S21ScaleExpr;
+  template <class U>
+  friend class S21BasicMatrixView;
+  template <class U>
+  friend class S21BasicMatrix;
+  void AllocMatrix(int rows, int cols);
+  void Reallocate(int cap_rows, int ld);
+  void SetRowCount(int rows);
   void RemoveMatrix();
-  void CopyMatrix(const S21Matrix& other);
-  void GetCofact(S21Matrix& other, int p, int q) const;
-  double GetDeterminant();
+  void CopyMatrix(const S21BasicMatrix& other);
+  void StealMatrix(S21BasicMatrix& other) noexcept;
+  [[nodiscard]] Real SingularTolerance() const;
+  void PivotTolerances(Real* row_tol, Real* col_tol) const;
+  int LuDecompose(int* perm);
+  void LuSolve(const int* perm, T* b, int ldb, int m) const;
+  bool InvertInPlace(T* det = nullptr);
+  int FullPivotLu(int* row_perm, int* col_perm);
+  int NullVector(T* z) const;
+  void SingularComplements(S21BasicMatrix& res) const;
+  void MinorComplements(S21BasicMatrix& res) const;
+  T BareissDeterminant();
+  T DeterminantInPlace();
   [[nodiscard]] bool CheckMatrix() const;
 
  public:
   [[nodiscard]] int rows() const;
   [[nodiscard]] int cols() const;
-  [[nodiscard]] double** matrix() const;
+  [[nodiscard]] T** matrix() const;
+  // Resizing keeps the overlapping elements and zero-fills the new ones. It
+  // happens in place within the capacity; beyond it the storage grows to at
+  // least twice the capacity in that dimension, so appending rows one at a
+  // time copies each element O(1) times on average.
   void set_rows(int rows);
   void set_cols(int cols);
+  // Room for row_capacity() rows of col_capacity() elements; col_capacity()
+  // is stride().
+  [[nodiscard]] int row_capacity() const { return cap_rows_; }
+  [[nodiscard]] int col_capacity() const { return ld_; }
+  // Grows the capacity to at least rows x cols without changing the shape;
+  // never shrinks it. Throws std::length_error for negative sizes.
+  void reserve(int rows, int cols);
+  // Releases the capacity beyond rows() x cols().
+  void shrink_to_fit();
+
+  S21BasicMatrix();
+  S21BasicMatrix(int rows, int cols);
+  S21BasicMatrix(const S21BasicMatrix& other);
+  S21BasicMatrix(S21BasicMatrix&& other) noexcept;
+  template <class E>
+  S21BasicMatrix(const S21MatrixExpr<E>& expr);
+  ~S21BasicMatrix();
+
+  bool EqMatrix(const S21BasicMatrix& other);
+  // Element-wise comparison under tolerance, false for another shape.
+  // Throws std::logic_error with TOLERANCE_MSG for a negative or NaN
+  // tolerance value.
+  bool EqMatrix(const_view_type other, s21::Tolerance tolerance) const;
+  void SumMatrix(const_view_type other);
+  void SubMatrix(const_view_type other);
+  void MulNumber(const T num);
+  void MulMatrix(const_view_type other,
+                 s21::MulAlgorithm algo = s21::MulAlgorithm::kClassic);
+  // In-place updates that write into *this without allocating:
+  // Gemm sets *this = alpha * a * b + beta * *this, Axpy adds alpha * x.
+  // Operands overlapping *this are copied first.
+  void Gemm(T alpha, const_view_type a, const_view_type b, T beta,
+            s21::MulAlgorithm algo = s21::MulAlgorithm::kClassic);
+  void Axpy(T alpha, const_view_type x);
+  S21BasicMatrix Transpose();
+  S21BasicMatrix CalcComplements();
+  T Determinant();
+  S21BasicMatrix InverseMatrix();
+  // X with *this * X = b for a square *this, one column of b per right-hand
+  // side, by LU factorization with partial pivoting and blocked triangular
+  // solves; the inverse is never formed. Throws std::logic_error with
+  // EMPTY_MSG, SQUARE_MSG, INTEGER_MSG, CORRESPOND_MSG if b has another
+  // number of rows, or NULL_DET_MSG for a singular matrix.
+  [[nodiscard]] S21BasicMatrix Solve(const_view_type b) const;
+  // Same, overwriting b, or the single right-hand side x, with the solution.
+  void SolveInPlace(view_type b) const;
+  void SolveInPlace(S21Span<T> x) const;
 
-  S21Matrix();
-  S21Matrix(int rows, int cols);
-  S21Matrix(const S21Matrix& other);
-  S21Matrix(S21Matrix&& other) noexcept;
-  ~S21Matrix();
-
-  bool EqMatrix(const S21Matrix& other);
-  void SumMatrix(const S21Matrix& other);
-  void SubMatrix(const S21Matrix& other);
-  void MulNumber(const double num);
-  void MulMatrix(const S21Matrix& other);
-  S21Matrix Transpose();
-  S21Matrix CalcComplements();
-  double Determinant();
-  S21Matrix InverseMatrix();
-
-  S21Matrix operator+(const S21Matrix& other);
-  S21Matrix operator-(const S21Matrix& other);
-  S21Matrix operator*(const double num);
-  S21Matrix operator*(const S21Matrix& other);
-  bool operator==(const S21Matrix& other);
-  S21Matrix& operator=(const S21Matrix& other);
-  S21Matrix operator+=(const S21Matrix& other);
-  S21Matrix operator-=(const S21Matrix& other);
-  S21Matrix operator*=(const double num);
-  S21Matrix operator*=(const S21Matrix& other);
-
-  double& operator()(int i, int j);
-  double& operator()(int i, int j) const;
+  template <class L, class R>
+  friend S21BasicMatrix<typename L::value_type> operator*(
+      const S21MatrixExpr<L>& l, const S21MatrixExpr<R>& r);
+  bool operator==(const S21BasicMatrix& other);
+  S21BasicMatrix& operator=(const S21BasicMatrix& other);
+  S21BasicMatrix& operator=(S21BasicMatrix&& other) noexcept;
+  template <class E>
+  S21BasicMatrix& operator=(const S21MatrixExpr<E>& expr);
+  S21BasicMatrix& operator+=(const S21BasicMatrix& other);
+  S21BasicMatrix& operator-=(const S21BasicMatrix& other);
+  S21BasicMatrix& operator*=(const T num);
+  S21BasicMatrix& operator*=(const_view_type other);
+  template <class E>
+  S21BasicMatrix& operator+=(const S21MatrixExpr<E>& expr);
+  template <class E>
+  S21BasicMatrix& operator-=(const S21MatrixExpr<E>& expr);
+
+  // Unchecked element access for hot loops; indices are only validated by
+  // assert() in debug builds. at() throws std::length_error instead.
+  T& operator()(int i, int j) {
+    assert(i >= 0 && i < rows_ && j >= 0 && j < cols_);
+    return Row(i)[j];
+  }
+  const T& operator()(int i, int j) const {
+    assert(i >= 0 && i < rows_ && j >= 0 && j < cols_);
+    return Row(i)[j];
+  }
+  T& at(int i, int j);
+  const T& at(int i, int j) const;
+
+  // Row i as a span of cols() elements, and the raw storage: element (i, j)
+  // is data()[i * stride() + j].
+  [[nodiscard]] S21Span<T> row(int i) {
+    assert(i >= 0 && i < rows_);
+    return {Row(i), cols_};
+  }
+  [[nodiscard]] S21Span<const T> row(int i) const {
+    assert(i >= 0 && i < rows_);
+    return {Row(i), cols_};
+  }
+  [[nodiscard]] T* data() { return data_; }
+  [[nodiscard]] const T* data() const { return data_; }
+  [[nodiscard]] int stride() const { return ld_; }
+
+  // Non-owning views of the whole matrix, a rows x cols block at (row, col),
+  // the transpose and the minor without row `row` and column `col`. They
+  // stay valid until the matrix is resized, moved from or destroyed.
+  [[nodiscard]] view_type View() { return {data_, rows_, cols_, ld_, 1}; }
+  [[nodiscard]] const_view_type View() const {
+    return {data_, rows_, cols_, ld_, 1};
+  }
+  operator const_view_type() const { return View(); }
+  [[nodiscard]] view_type Block(int row, int col, int rows, int cols) {
+    return View().Block(row, col, rows, cols);
+  }
+  [[nodiscard]] const_view_type Block(int row, int col, int rows,
+                                      int cols) const {
+    return View().Block(row, col, rows, cols);
+  }
+  [[nodiscard]] view_type TransposedView() { return View().Transposed(); }
+  [[nodiscard]] const_view_type TransposedView() const {
+    return View().Transposed();
+  }
+  [[nodiscard]] view_type MinorView(int row, int col) {
+    return View().Minor(row, col);
+  }
+  [[nodiscard]] const_view_type MinorView(int row, int col) const {
+    return View().Minor(row, col);
+  }
 };
 
+using S21Matrix = S21BasicMatrix<double>;
+using S21FloatMatrix = S21BasicMatrix<float>;
+using S21Int64Matrix = S21BasicMatrix<std::int64_t>;
+using S21ComplexMatrix = S21BasicMatrix<std::complex<double>>;
+
+extern template class S21BasicMatrix<float>;
+extern template class S21BasicMatrix<double>;
+extern template class S21BasicMatrix<std::int64_t>;
+extern template class S21BasicMatrix<std::complex<double>>;
+
+namespace s21 {
+
+// Matrices and views are multiplied where they are; any other expression is
+// evaluated into tmp first.
+template <class E, class T>
+S21BasicMatrixView<const T> ProductOperand(const E& e,
+                                           S21BasicMatrix<T>& tmp) {
+  if constexpr (std::is_convertible_v<const E&, S21BasicMatrixView<const T>>) {
+    return e;
+  } else {
+    tmp = e;
+    return tmp;
+  }
+}
+
+}  // namespace s21
+
+// Matrix products are evaluated eagerly; expression operands are
+// materialized first, plain matrices and views are used as they are.
+template <class L, class R>
+S21BasicMatrix<typename L::value_type> operator*(const S21MatrixExpr<L>& l,
+                                                 const S21MatrixExpr<R>& r) {
+  using T = typename L::value_type;
+  static_assert(std::is_same_v<T, typename R::value_type>,
+                "operands of a product must have the same element type");
+  S21BasicMatrix<T> lt, rt;
+  return S21BasicMatrix<T>::Product(s21::ProductOperand(l.self(), lt),
+                                    s21::ProductOperand(r.self(), rt));
+}
+
+template <class T>
+template <class E>
+S21BasicMatrix<T>::S21BasicMatrix(const S21MatrixExpr<E>& expr)
+    : S21BasicMatrix(expr.self().rows(), expr.self().cols()) {
+  EvalExpr(expr.self());
+}
+
+template <class T>
+template <class E>
+S21BasicMatrix<T>& S21BasicMatrix<T>::operator=(
+    const S21MatrixExpr<E>& expr) {
+  const E& e = expr.self();
+  if (data_ == nullptr || rows_ != e.rows() || cols_ != e.cols() ||
+      e.Aliases(*this))
+    return *this = S21BasicMatrix(expr);
+  // Element-wise nodes read each position only to write the same position,
+  // so evaluating straight into an operand is safe unless a view reads it in
+  // a different layout.
+  EvalExpr(e);
+  return *this;
+}
+
+template <class T>
+template <class E>
+S21BasicMatrix<T>& S21BasicMatrix<T>::operator+=(
+    const S21MatrixExpr<E>& expr) {
+  return *this = *this + expr;
+}
+
+template <class T>
+template <class E>
+S21BasicMatrix<T>& S21BasicMatrix<T>::operator-=(
+    const S21MatrixExpr<E>& expr) {
+  return *this = *this - expr;
+}
+
+template <class T>
+template <class E>
+void S21BasicMatrix<T>::EvalExpr(const E& expr) {
+  S21_STATS_OP(kEvalExpr, rows_, cols_);
+  s21::ParallelFor(rows_, cols_, [&](int begin, int end) {
+    for (int i = begin; i < end; i++) {
+      T* out = Row(i);
+      for (int j = 0; j < cols_; j++) out[j] = expr.At(i, j);
+    }
+  });
+}
+
 #endif  // CPP1_S21_MATRIXPLUS_1_S21_MATRIX_OOP_H
@@ -0,0 +1,169 @@
+#ifndef CPP1_S21_MATRIXPLUS_1_S21_MATRIX_VIEW_H
+#define CPP1_S21_MATRIXPLUS_1_S21_MATRIX_VIEW_H
+
+#include <cassert>
+#include <climits>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// Included from s21_matrix_oop.h, which provides the error messages.
+
+// Non-owning window onto matrix storage: element (i, j) of the view is
+// data[i * row_stride + j * col_stride]. Blocks, single rows and columns and
+// transposes are all expressible this way. A minor additionally skips one
+// source row and one source column.
+//
+// Views take part in the lazy element-wise operators and in matrix products
+// (strided views feed the GEMM kernel directly) without copying. A view is
+// only valid while the matrix it was taken from keeps its storage.
+template <class T>
+class S21BasicMatrixView : public S21MatrixExpr<S21BasicMatrixView<T>> {
+ public:
+  using value_type = std::remove_const_t<T>;
+
+  S21BasicMatrixView(T* data, int rows, int cols, int row_stride,
+                     int col_stride)
+      : data_(data),
+        rows_(rows),
+        cols_(cols),
+        row_stride_(row_stride),
+        col_stride_(col_stride),
+        skip_row_(kNoSkip),
+        skip_col_(kNoSkip) {}
+  // Writable views convert to read-only ones.
+  template <class U, class = std::enable_if_t<std::is_same_v<const U, T> &&
+                                              !std::is_same_v<U, T>>>
+  S21BasicMatrixView(const S21BasicMatrixView<U>& other)
+      : data_(other.data_),
+        rows_(other.rows_),
+        cols_(other.cols_),
+        row_stride_(other.row_stride_),
+        col_stride_(other.col_stride_),
+        skip_row_(other.skip_row_),
+        skip_col_(other.skip_col_) {}
+
+  [[nodiscard]] int rows() const { return rows_; }
+  [[nodiscard]] int cols() const { return cols_; }
+  [[nodiscard]] T* data() const { return data_; }
+  [[nodiscard]] int row_stride() const { return row_stride_; }
+  [[nodiscard]] int col_stride() const { return col_stride_; }
+  // True for plain strided views, which need no index remapping.
+  [[nodiscard]] bool strided() const {
+    return skip_row_ == kNoSkip && skip_col_ == kNoSkip;
+  }
+
+  T& operator()(int i, int j) const {
+    assert(i >= 0 && i < rows_ && j >= 0 && j < cols_);
+    return data_[Offset(i, j)];
+  }
+  [[nodiscard]] value_type At(int i, int j) const {
+    return data_[Offset(i, j)];
+  }
+
+  // True if any element of this view may lie in [begin, end). Address ranges
+  // are compared, so interleaved but disjoint views count as overlapping.
+  [[nodiscard]] bool Overlaps(const value_type* begin,
+                              const value_type* end) const {
+    if (rows_ < 1 || cols_ < 1) return false;
+    return data_ < end && data_ + Offset(rows_ - 1, cols_ - 1) >= begin;
+  }
+  [[nodiscard]] bool Overlaps(
+      const S21BasicMatrixView<const value_type>& other) const {
+    if (other.rows_ < 1 || other.cols_ < 1) return false;
+    return Overlaps(other.data_,
+                    other.data_ + other.Offset(other.rows_ - 1,
+                                               other.cols_ - 1) + 1);
+  }
+  // Reading element (i, j) of the same layout while writing it is fine;
+  // anything else that touches dst's storage is not.
+  [[nodiscard]] bool Aliases(
+      const S21BasicMatrixView<const value_type>& dst) const {
+    bool same = data_ == dst.data_ && row_stride_ == dst.row_stride_ &&
+                col_stride_ == dst.col_stride_ && strided() && dst.strided();
+    return !same && Overlaps(dst);
+  }
+
+  [[nodiscard]] S21BasicMatrixView Block(int row, int col, int rows,
+                                         int cols) const {
+    if (row < 0 || col < 0 || rows < 0 || cols < 0 || row + rows > rows_ ||
+        col + cols > cols_)
+      throw std::length_error(RANGE_MSG);
+    S21BasicMatrixView res = *this;
+    res.data_ = data_ + Offset(row, col);
+    res.rows_ = rows;
+    res.cols_ = cols;
+    res.skip_row_ = InnerSkip(skip_row_, row, rows);
+    res.skip_col_ = InnerSkip(skip_col_, col, cols);
+    return res;
+  }
+  [[nodiscard]] S21BasicMatrixView RowView(int i) const {
+    return Block(i, 0, 1, cols_);
+  }
+  [[nodiscard]] S21BasicMatrixView ColView(int j) const {
+    return Block(0, j, rows_, 1);
+  }
+  [[nodiscard]] S21BasicMatrixView Transposed() const {
+    S21BasicMatrixView res = *this;
+    std::swap(res.rows_, res.cols_);
+    std::swap(res.row_stride_, res.col_stride_);
+    std::swap(res.skip_row_, res.skip_col_);
+    return res;
+  }
+  // The view without row `row` and column `col`. Only one level of minors is
+  // supported; take a minor of a minor through a copy.
+  [[nodiscard]] S21BasicMatrixView Minor(int row, int col) const {
+    if (row < 0 || row >= rows_ || col < 0 || col >= cols_)
+      throw std::length_error(RANGE_MSG);
+    if (!strided()) throw std::logic_error(MINOR_MSG);
+    S21BasicMatrixView res = *this;
+    res.rows_--;
+    res.cols_--;
+    res.skip_row_ = row;
+    res.skip_col_ = col;
+    return res;
+  }
+
+  // Writes the value of an expression into the viewed elements. The
+  // expression must not read elements of this view other than the one being
+  // written, e.g. a transposed view of the same block.
+  template <class E, class U = T,
+            class = std::enable_if_t<!std::is_const_v<U>>>
+  void Assign(const S21MatrixExpr<E>& expr) const {
+    const E& e = expr.self();
+    if (e.rows() != rows_ || e.cols() != cols_)
+      throw std::logic_error(CORRESPOND_MSG);
+    for (int i = 0; i < rows_; i++)
+      for (int j = 0; j < cols_; j++) data_[Offset(i, j)] = e.At(i, j);
+  }
+
+ private:
+  template <class U>
+  friend class S21BasicMatrixView;
+
+  static constexpr int kNoSkip = INT_MAX;
+
+  // Skip of a block of `count` lines starting at `first`: only a skipped
+  // line strictly inside the block needs remapping there, anything else
+  // leaves the block plainly strided.
+  [[nodiscard]] static int InnerSkip(int skip, int first, int count) {
+    return first < skip && skip - first < count ? skip - first : kNoSkip;
+  }
+  [[nodiscard]] std::ptrdiff_t Offset(int i, int j) const {
+    i += i >= skip_row_;
+    j += j >= skip_col_;
+    return static_cast<std::ptrdiff_t>(i) * row_stride_ +
+           static_cast<std::ptrdiff_t>(j) * col_stride_;
+  }
+
+  T* data_;
+  int rows_, cols_;
+  int row_stride_, col_stride_;
+  int skip_row_, skip_col_;
+};
+
+using S21MatrixView = S21BasicMatrixView<double>;
+using S21ConstMatrixView = S21BasicMatrixView<const double>;
+
+#endif  // CPP1_S21_MATRIXPLUS_1_S21_MATRIX_VIEW_H
@@ -0,0 +1,132 @@
+#include "s21_out_of_core.h"
+
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <future>
+#include <stdexcept>
+
+#include "s21_gemm.h"
+#include "s21_matrix_io.h"
+
+namespace {
+
+// Tiles kept in memory: two of A and two of B for the prefetch, one of C.
+constexpr int kTileBuffers = 5;
+
+bool SameFile(const std::string& x, const std::string& y) {
+  struct stat sx, sy;
+  if (::stat(x.c_str(), &sx) != 0 || ::stat(y.c_str(), &sy) != 0)
+    return false;
+  return sx.st_dev == sy.st_dev && sx.st_ino == sy.st_ino;
+}
+
+// Largest tile edge whose buffers fit in budget bytes, a multiple of the
+// 64-row GEMM blocking where that is possible.
+int TileFor(std::size_t budget, std::size_t element) {
+  auto t = static_cast<long>(
+      std::sqrt(static_cast<double>(budget / (kTileBuffers * element))));
+  t = std::min(t, 1L << 16);
+  if (t >= 64) t -= t % 64;
+  if (t < 1) throw std::length_error(BUDGET_MSG);
+  return static_cast<int>(t);
+}
+
+}  // namespace
+
+namespace s21 {
+
+template <class T>
+OutOfCoreStats MulMatrixFiles(const std::string& a_path,
+                              const std::string& b_path,
+                              const std::string& c_path,
+                              const OutOfCoreOptions& options) {
+  S21MatrixFile<T> a(a_path), b(b_path);
+  if (a.cols() != b.rows()) throw std::logic_error(CORRESPOND_MSG);
+  if (SameFile(c_path, a_path) || SameFile(c_path, b_path))
+    throw std::logic_error(ALIAS_MSG);
+  int m = a.rows(), k = a.cols(), n = b.cols();
+  int t = options.tile > 0 ? options.tile
+                           : TileFor(options.memory_budget, sizeof(T));
+  int tm = std::max(1, std::min(t, m)), tk = std::max(1, std::min(t, k));
+  int tn = std::max(1, std::min(t, n));
+  OutOfCoreStats stats{};
+  stats.tile = t;
+  stats.buffer_bytes = (2 * static_cast<std::size_t>(tm) * tk +
+                        2 * static_cast<std::size_t>(tk) * tn +
+                        static_cast<std::size_t>(tm) * tn) *
+                       sizeof(T);
+  if (stats.buffer_bytes > options.memory_budget)
+    throw std::length_error(BUDGET_MSG);
+  S21MatrixFile<T> c = S21MatrixFile<T>::Create(c_path, m, n);
+  // The new file is already all zeros.
+  if (m == 0 || n == 0 || k == 0) return stats;
+
+  S21BasicMatrix<T> a_tile[2] = {{tm, tk}, {tm, tk}};
+  S21BasicMatrix<T> b_tile[2] = {{tk, tn}, {tk, tn}};
+  S21BasicMatrix<T> c_tile(tm, tn);
+  int row_tiles = (m + t - 1) / t, col_tiles = (n + t - 1) / t;
+  int depth_tiles = (k + t - 1) / t;
+  long steps = static_cast<long>(row_tiles) * col_tiles * depth_tiles;
+  // Step s multiplies A tile (i, p) by B tile (p, j), with p fastest.
+  struct Step {
+    int i, j, p, rows, cols, depth;
+  };
+  auto step_at = [&](long s) {
+    Step st;
+    st.p = static_cast<int>(s % depth_tiles);
+    st.j = static_cast<int>(s / depth_tiles % col_tiles);
+    st.i = static_cast<int>(s / depth_tiles / col_tiles);
+    st.rows = std::min(t, m - st.i * t);
+    st.cols = std::min(t, n - st.j * t);
+    st.depth = std::min(t, k - st.p * t);
+    return st;
+  };
+  auto load = [&](long s) {
+    Step st = step_at(s);
+    a.ReadBlock(st.i * t, st.p * t,
+                a_tile[s % 2].Block(0, 0, st.rows, st.depth));
+    b.ReadBlock(st.p * t, st.j * t,
+                b_tile[s % 2].Block(0, 0, st.depth, st.cols));
+  };
+
+  load(0);
+  for (long s = 0; s < steps; s++) {
+    // The other buffer pair was consumed by step s - 1, so the read for
+    // step s + 1 can start before step s computes.
+    std::future<void> next;
+    if (s + 1 < steps) next = std::async(std::launch::async, load, s + 1);
+    Step st = step_at(s);
+    const S21BasicMatrix<T>& at = a_tile[s % 2];
+    const S21BasicMatrix<T>& bt = b_tile[s % 2];
+    Gemm(st.rows, st.cols, st.depth, T(1), at.data(), at.stride(), bt.data(),
+         bt.stride(), st.p == 0 ? T(0) : T(1), c_tile.data(),
+         c_tile.stride());
+    if (st.p == depth_tiles - 1) {
+      c.WriteBlock(st.i * t, st.j * t,
+                   c_tile.View().Block(0, 0, st.rows, st.cols));
+      stats.tiles_written++;
+    }
+    auto wait = std::chrono::steady_clock::now();
+    if (next.valid()) next.get();
+    stats.io_wait_seconds += std::chrono::duration<double>(
+                                 std::chrono::steady_clock::now() - wait)
+                                 .count();
+  }
+  stats.tiles_read = 2 * steps;
+  return stats;
+}
+
+#define S21_OUT_OF_CORE_INSTANTIATE(T)                                     \
+  template OutOfCoreStats MulMatrixFiles<T>(                               \
+      const std::string&, const std::string&, const std::string&,          \
+      const OutOfCoreOptions&);
+S21_OUT_OF_CORE_INSTANTIATE(float)
+S21_OUT_OF_CORE_INSTANTIATE(double)
+S21_OUT_OF_CORE_INSTANTIATE(std::int64_t)
+S21_OUT_OF_CORE_INSTANTIATE(std::complex<double>)
+#undef S21_OUT_OF_CORE_INSTANTIATE
+
+}  // namespace s21
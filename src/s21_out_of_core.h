@@ -0,0 +1,52 @@
+#ifndef CPP1_S21_MATRIXPLUS_1_S21_OUT_OF_CORE_H
+#define CPP1_S21_MATRIXPLUS_1_S21_OUT_OF_CORE_H
+
+#include <cstddef>
+#include <string>
+
+#define BUDGET_MSG "Memory budget is too small for the tiles"
+#define ALIAS_MSG "The product file must differ from the operand files"
+
+namespace s21 {
+
+struct OutOfCoreOptions {
+  // Upper bound on the tile buffers held at once, in bytes.
+  std::size_t memory_budget = std::size_t{256} << 20;
+  // Edge of the square tiles; 0 picks the largest that fits the budget.
+  int tile = 0;
+};
+
+struct OutOfCoreStats {
+  int tile;
+  // Tile buffers actually held, at most memory_budget.
+  std::size_t buffer_bytes;
+  long tiles_read;
+  long tiles_written;
+  // Time the multiply spent waiting for a prefetch to finish, i.e. the
+  // I/O that computing did not hide.
+  double io_wait_seconds;
+};
+
+// Writes the product of the matrix files at a_path and b_path (see
+// s21_matrix_io.h) to a new file at c_path, holding only tiles of the three
+// matrices in memory. Each tile of C accumulates the products of a row of A
+// tiles and a column of B tiles; while one pair is multiplied, the next is
+// read by a background thread into a second pair of buffers, and finished C
+// tiles are written straight back. That is five tiles of tile x tile
+// elements, which with tile = 0 is the largest size within memory_budget;
+// the page cache and the per-thread packing buffers of Gemm (a few MiB) come
+// on top. Each tile product runs on the thread pool.
+//
+// Throws std::logic_error if the shapes do not correspond or, with
+// ALIAS_MSG, if c_path names an operand file, and std::length_error with
+// BUDGET_MSG if the tiles do not fit the budget. Instantiated for the
+// S21BasicMatrix element types.
+template <class T>
+OutOfCoreStats MulMatrixFiles(const std::string& a_path,
+                              const std::string& b_path,
+                              const std::string& c_path,
+                              const OutOfCoreOptions& options = {});
+
+}  // namespace s21
+
+#endif  // CPP1_S21_MATRIXPLUS_1_S21_OUT_OF_CORE_H
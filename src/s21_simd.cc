@@ -0,0 +1,977 @@
+#include "s21_simd.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#if defined(__x86_64__)
+#define S21_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+namespace s21 {
+
+namespace {
+
+constexpr double kEqScale = 1e6;
+constexpr float kFloatEqTol = 1e-5f;
+// Elements compared between checks for an early exit in the vector loops
+// of the comparisons written with vector extensions.
+constexpr int kEqChunk = 256;
+
+using Complex = std::complex<double>;
+
+template <class T>
+struct Kernels {
+  void (*add)(T*, const T*, int);
+  void (*sub)(T*, const T*, int);
+  void (*scale)(T*, T, int);
+  void (*axpy)(T*, T, const T*, int);
+  bool (*eq)(const T*, const T*, int);
+};
+
+// Complex addition and comparison run on the double kernels over the real
+// and imaginary parts; only products need kernels of their own.
+struct ComplexKernels {
+  void (*scale)(Complex*, Complex, int);
+  void (*axpy)(Complex*, Complex, const Complex*, int);
+};
+
+// Scalar versions, also used for the tails of the vector loops.
+
+template <class T>
+void AddScalar(T* a, const T* b, int n) {
+  for (int j = 0; j < n; j++) a[j] += b[j];
+}
+
+template <class T>
+void SubScalar(T* a, const T* b, int n) {
+  for (int j = 0; j < n; j++) a[j] -= b[j];
+}
+
+template <class T>
+void ScaleScalar(T* a, T num, int n) {
+  for (int j = 0; j < n; j++) a[j] *= num;
+}
+
+// a * x is rounded before the add (no FMA) at every level, so y += a * x
+// gives the same bits as the unfused ScaleRow/AddRow sequence.
+template <class T>
+void AxpyScalar(T* y, T a, const T* x, int n) {
+  for (int j = 0; j < n; j++) y[j] += a * x[j];
+}
+
+bool EqScalar(const double* a, const double* b, int n) {
+  for (int j = 0; j < n; j++)
+    if (std::round(a[j] * kEqScale) != std::round(b[j] * kEqScale))
+      return false;
+  return true;
+}
+
+bool EqScalar(const float* a, const float* b, int n) {
+  for (int j = 0; j < n; j++) {
+    float lim =
+        kFloatEqTol * std::max({1.0f, std::fabs(a[j]), std::fabs(b[j])});
+    if (a[j] != b[j] && !(std::fabs(a[j] - b[j]) <= lim)) return false;
+  }
+  return true;
+}
+
+bool EqScalar(const std::uint64_t* a, const std::uint64_t* b, int n) {
+  return std::equal(a, a + n, b);
+}
+
+template <class T>
+using BitsOf =
+    std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+
+// A non-negative tolerance value as a step count, saturating.
+template <class U>
+U Steps(double value) {
+  constexpr U kMax = std::numeric_limits<U>::max();
+  return value < static_cast<double>(kMax) ? static_cast<U>(value) : kMax;
+}
+
+// Tolerance in the element type: the bound of kAbsolute and kRelative and
+// the step count of kUlp. The largest count is kept for NaNs; any two
+// other numbers are closer.
+template <class T>
+struct Near {
+  T tol;
+  BitsOf<T> ulps;
+};
+
+template <class T>
+Near<T> NearOf(Tolerance tolerance) {
+  constexpr BitsOf<T> kFar = std::numeric_limits<BitsOf<T>>::max();
+  return {static_cast<T>(tolerance.value),
+          std::min(Steps<BitsOf<T>>(tolerance.value), kFar - 1)};
+}
+
+// The bits of x as an integer ordered like x, with -0 and +0 both zero, so
+// the ULP distance of two numbers is the difference of theirs: negative
+// numbers become minus their magnitude bits.
+template <class T>
+std::make_signed_t<BitsOf<T>> OrderedBits(T x) {
+  using S = std::make_signed_t<BitsOf<T>>;
+  S i;
+  std::memcpy(&i, &x, sizeof(x));
+  return i < 0 ? -(i & std::numeric_limits<S>::max()) : i;
+}
+
+// |x - y|, which need not fit in the signed type.
+template <class S>
+std::make_unsigned_t<S> Distance(S x, S y) {
+  using U = std::make_unsigned_t<S>;
+  return x > y ? static_cast<U>(x) - static_cast<U>(y)
+               : static_cast<U>(y) - static_cast<U>(x);
+}
+
+template <EqMode kMode, class T>
+bool NearElems(const T* a, const T* b, int n, Near<T> near) {
+  for (int j = 0; j < n; j++) {
+    T x = a[j], y = b[j];
+    if (x == y) continue;
+    if (kMode == EqMode::kUlp) {
+      if (std::isnan(x) || std::isnan(y) ||
+          Distance(OrderedBits(x), OrderedBits(y)) > near.ulps)
+        return false;
+    } else {
+      T lim = kMode == EqMode::kAbsolute
+                  ? near.tol
+                  : std::max(std::fabs(x), std::fabs(y)) * near.tol;
+      if (!(std::fabs(x - y) <= lim)) return false;
+    }
+  }
+  return true;
+}
+
+template <class T>
+bool NearScalar(const T* a, const T* b, int n, EqMode mode, Near<T> near) {
+  switch (mode) {
+    case EqMode::kAbsolute:
+      return NearElems<EqMode::kAbsolute>(a, b, n, near);
+    case EqMode::kRelative:
+      return NearElems<EqMode::kRelative>(a, b, n, near);
+    default:
+      return NearElems<EqMode::kUlp>(a, b, n, near);
+  }
+}
+
+// Complex rows are handled as interleaved (re, im) doubles.
+void ComplexScaleScalar(double* a, double re, double im, int n) {
+  for (int j = 0; j < n; j++, a += 2) {
+    double r = a[0] * re - a[1] * im;
+    a[1] = a[1] * re + a[0] * im;
+    a[0] = r;
+  }
+}
+
+void ComplexAxpyScalar(double* y, double re, double im, const double* x,
+                       int n) {
+  for (int j = 0; j < n; j++, y += 2, x += 2) {
+    y[0] += x[0] * re - x[1] * im;
+    y[1] += x[1] * re + x[0] * im;
+  }
+}
+
+void ComplexScaleScalar(Complex* a, Complex num, int n) {
+  ComplexScaleScalar(reinterpret_cast<double*>(a), num.real(), num.imag(), n);
+}
+
+void ComplexAxpyScalar(Complex* y, Complex a, const Complex* x, int n) {
+  ComplexAxpyScalar(reinterpret_cast<double*>(y), a.real(), a.imag(),
+                    reinterpret_cast<const double*>(x), n);
+}
+
+// Kernels for the other element types are written once with GCC vector
+// extensions over kBytes-wide vectors and instantiated for each level below;
+// inlining them into a function with a target attribute compiles them for
+// that instruction set.
+template <class T, int kBytes>
+struct VecOf {
+  typedef T type __attribute__((vector_size(kBytes), aligned(alignof(T))));
+};
+template <class T, int kBytes>
+using Vec = typename VecOf<T, kBytes>::type;
+
+template <int kBytes, class T>
+[[gnu::always_inline]] inline Vec<T, kBytes>& VecAt(T* p) {
+  return *reinterpret_cast<Vec<T, kBytes>*>(p);
+}
+
+template <int kBytes, class T>
+[[gnu::always_inline]] inline const Vec<T, kBytes>& VecAt(const T* p) {
+  return *reinterpret_cast<const Vec<T, kBytes>*>(p);
+}
+
+template <int kBytes, class T>
+[[gnu::always_inline]] inline void AddVec(T* a, const T* b, int n) {
+  constexpr int kLanes = kBytes / sizeof(T);
+  int j = 0;
+  for (; j + kLanes <= n; j += kLanes)
+    VecAt<kBytes>(a + j) += VecAt<kBytes>(b + j);
+  AddScalar(a + j, b + j, n - j);
+}
+
+template <int kBytes, class T>
+[[gnu::always_inline]] inline void SubVec(T* a, const T* b, int n) {
+  constexpr int kLanes = kBytes / sizeof(T);
+  int j = 0;
+  for (; j + kLanes <= n; j += kLanes)
+    VecAt<kBytes>(a + j) -= VecAt<kBytes>(b + j);
+  SubScalar(a + j, b + j, n - j);
+}
+
+template <int kBytes, class T>
+[[gnu::always_inline]] inline void ScaleVec(T* a, T num, int n) {
+  constexpr int kLanes = kBytes / sizeof(T);
+  int j = 0;
+  for (; j + kLanes <= n; j += kLanes) VecAt<kBytes>(a + j) *= num;
+  ScaleScalar(a + j, num, n - j);
+}
+
+template <int kBytes, class T>
+[[gnu::always_inline]] inline void AxpyVec(T* y, T a, const T* x, int n) {
+  constexpr int kLanes = kBytes / sizeof(T);
+  int j = 0;
+  for (; j + kLanes <= n; j += kLanes)
+    VecAt<kBytes>(y + j) += a * VecAt<kBytes>(x + j);
+  AxpyScalar(y + j, a, x + j, n - j);
+}
+
+// Lane masks produced by comparing two vectors of T.
+template <class T, int kBytes>
+using Mask = decltype(Vec<T, kBytes>{} != Vec<T, kBytes>{});
+
+// Sets the lanes of bad where the EqScalar rule fails for the element type.
+template <int kBytes>
+[[gnu::always_inline]] inline void Mismatch(Mask<float, kBytes>& bad,
+                                            const float* a, const float* b) {
+  using V = Vec<float, kBytes>;
+  V va = VecAt<kBytes>(a), vb = VecAt<kBytes>(b);
+  V aa = va < 0 ? -va : va, ab = vb < 0 ? -vb : vb;
+  V d = va - vb;
+  d = d < 0 ? -d : d;
+  V lim = aa > ab ? aa : ab;
+  lim = lim > 1 ? lim : 1;
+  bad |= (va != vb) & ~(d <= kFloatEqTol * lim);
+}
+
+template <int kBytes>
+[[gnu::always_inline]] inline void Mismatch(Mask<std::uint64_t, kBytes>& bad,
+                                            const std::uint64_t* a,
+                                            const std::uint64_t* b) {
+  bad |= VecAt<kBytes>(a) != VecAt<kBytes>(b);
+}
+
+template <int kBytes, class T>
+[[gnu::always_inline]] inline bool EqVec(const T* a, const T* b, int n) {
+  constexpr int kLanes = kBytes / sizeof(T);
+  int j = 0;
+  while (j + kLanes <= n) {
+    int end = std::min(n - kLanes, j + kEqChunk);
+    Mask<T, kBytes> bad = {};
+    for (; j <= end; j += kLanes) Mismatch<kBytes>(bad, a + j, b + j);
+    for (int l = 0; l < kLanes; l++)
+      if (bad[l]) return false;
+  }
+  return EqScalar(a + j, b + j, n - j);
+}
+
+// v = |v|, by clearing the sign bits.
+template <int kBytes, class T>
+[[gnu::always_inline]] inline void AbsVec(Vec<T, kBytes>& v) {
+  using S = std::make_signed_t<BitsOf<T>>;
+  v = (Vec<T, kBytes>)((Vec<S, kBytes>)v & std::numeric_limits<S>::max());
+}
+
+// Sets the lanes of bad where elements do not match under kMode, by the
+// NearElems rule. Floating-point comparisons feed at most one select on
+// the way to the final distance <= bound test: GCC compiles longer chains
+// lane by lane at the kAvx512 level, which lacks AVX512DQ.
+template <EqMode kMode, int kBytes, class T>
+[[gnu::always_inline]] inline void NearMismatch(Mask<T, kBytes>& bad,
+                                                const T* a, const T* b,
+                                                Near<T> near) {
+  using V = Vec<T, kBytes>;
+  using M = Mask<T, kBytes>;
+  const M kAll = ~M{};
+  V va = VecAt<kBytes>(a), vb = VecAt<kBytes>(b);
+  M miss;
+  if constexpr (kMode == EqMode::kUlp) {
+    using S = std::make_signed_t<BitsOf<T>>;
+    using SV = Vec<S, kBytes>;
+    using UV = Vec<BitsOf<T>, kBytes>;
+    constexpr S kMax = std::numeric_limits<S>::max();
+    // Infinity: all exponent bits set. NaNs have larger magnitudes.
+    constexpr int kMantissa = std::numeric_limits<T>::digits - 1;
+    constexpr S kInf = static_cast<S>(~BitsOf<T>{} >> 1 >> kMantissa
+                                      << kMantissa);
+    // Vector casts reinterpret the bits.
+    SV ia = (SV)va, ib = (SV)vb;
+    ia = ia < 0 ? -(ia & kMax) : ia;
+    ib = ib < 0 ? -(ib & kMax) : ib;
+    UV ua = (UV)ia, ub = (UV)ib;
+    UV d = ia > ib ? ua - ub : ub - ua;
+    SV aa = ia < 0 ? -ia : ia, ab = ib < 0 ? -ib : ib;
+    // NaNs are beyond any near.ulps.
+    d = (aa > ab ? aa : ab) > kInf ? ~UV{} : d;
+    miss = d <= near.ulps ? M{} : kAll;
+  } else {
+    V d = va - vb;
+    AbsVec<kBytes, T>(d);
+    V lim;
+    if constexpr (kMode == EqMode::kAbsolute) {
+      lim = V{} + near.tol;
+    } else {
+      V aa = va, ab = vb;
+      AbsVec<kBytes, T>(aa);
+      AbsVec<kBytes, T>(ab);
+      lim = (aa > ab ? aa : ab) * near.tol;
+    }
+    // Equal infinities have a NaN distance, and their bound may be NaN.
+    d = va == vb ? V{} : d;
+    lim = va == vb ? V{} : lim;
+    miss = d <= lim ? M{} : kAll;
+  }
+  bad |= miss;
+}
+
+template <EqMode kMode, int kBytes, class T>
+[[gnu::always_inline]] inline bool NearChunks(const T* a, const T* b, int n,
+                                              Near<T> near) {
+  constexpr int kLanes = kBytes / sizeof(T);
+  int j = 0;
+  while (j + kLanes <= n) {
+    int end = std::min(n - kLanes, j + kEqChunk);
+    Mask<T, kBytes> bad = {};
+    for (; j <= end; j += kLanes)
+      NearMismatch<kMode, kBytes>(bad, a + j, b + j, near);
+    for (int l = 0; l < kLanes; l++)
+      if (bad[l]) return false;
+  }
+  return NearElems<kMode>(a + j, b + j, n - j, near);
+}
+
+template <int kBytes, class T>
+[[gnu::always_inline]] inline bool NearVec(const T* a, const T* b, int n,
+                                           EqMode mode, Near<T> near) {
+  switch (mode) {
+    case EqMode::kAbsolute:
+      return NearChunks<EqMode::kAbsolute, kBytes>(a, b, n, near);
+    case EqMode::kRelative:
+      return NearChunks<EqMode::kRelative, kBytes>(a, b, n, near);
+    default:
+      return NearChunks<EqMode::kUlp, kBytes>(a, b, n, near);
+  }
+}
+
+// out = x * (re + i im), or out += x * (re + i im) with kAdd, over n complex
+// numbers stored as (re, im) pairs. The pair-swapped vector supplies the
+// cross terms.
+template <int kBytes, bool kAdd>
+[[gnu::always_inline]] inline void ComplexMulVec(double* out, const double* x,
+                                                 double re, double im, int n) {
+  using V = Vec<double, kBytes>;
+  using M = Vec<std::int64_t, kBytes>;
+  constexpr int kLanes = kBytes / sizeof(double);
+  M swap;
+  V cross;
+  for (int l = 0; l < kLanes; l++) {
+    swap[l] = l ^ 1;
+    cross[l] = l % 2 ? im : -im;
+  }
+  int j = 0;
+  for (; j + kLanes / 2 <= n; j += kLanes / 2, out += kLanes, x += kLanes) {
+    V v = VecAt<kBytes>(x);
+    V prod = v * re + __builtin_shuffle(v, swap) * cross;
+    if (kAdd)
+      VecAt<kBytes>(out) += prod;
+    else
+      VecAt<kBytes>(out) = prod;
+  }
+  if (kAdd)
+    ComplexAxpyScalar(out, re, im, x, n - j);
+  else
+    ComplexScaleScalar(out, re, im, n - j);
+}
+
+template <int kBytes>
+[[gnu::always_inline]] inline void ComplexScaleVec(Complex* a, Complex num,
+                                                   int n) {
+  double* p = reinterpret_cast<double*>(a);
+  ComplexMulVec<kBytes, false>(p, p, num.real(), num.imag(), n);
+}
+
+template <int kBytes>
+[[gnu::always_inline]] inline void ComplexAxpyVec(Complex* y, Complex a,
+                                                  const Complex* x, int n) {
+  ComplexMulVec<kBytes, true>(reinterpret_cast<double*>(y),
+                              reinterpret_cast<const double*>(x), a.real(),
+                              a.imag(), n);
+}
+
+#ifdef S21_SIMD_X86
+
+// SSE2 has no rounding instruction. Adding and subtracting 2^52 rounds |x|
+// to the nearest integer with ties to even; a tie that went down is bumped up
+// so the result matches std::round (ties away from zero). Values of 2^52 and
+// above, infinities and NaNs are already integral and pass through.
+__m128d RoundSse2(__m128d x) {
+  const __m128d sign = _mm_set1_pd(-0.0);
+  const __m128d two52 = _mm_set1_pd(4503599627370496.0);
+  __m128d ax = _mm_andnot_pd(sign, x);
+  __m128d n = _mm_sub_pd(_mm_add_pd(ax, two52), two52);
+  __m128d tie = _mm_cmpeq_pd(_mm_sub_pd(ax, n), _mm_set1_pd(0.5));
+  n = _mm_add_pd(n, _mm_and_pd(tie, _mm_set1_pd(1.0)));
+  __m128d r = _mm_or_pd(n, _mm_and_pd(sign, x));
+  __m128d small = _mm_cmplt_pd(ax, two52);
+  return _mm_or_pd(_mm_and_pd(small, r), _mm_andnot_pd(small, x));
+}
+
+void AddSse2(double* a, const double* b, int n) {
+  int j = 0;
+  for (; j + 2 <= n; j += 2)
+    _mm_storeu_pd(a + j, _mm_add_pd(_mm_loadu_pd(a + j), _mm_loadu_pd(b + j)));
+  AddScalar(a + j, b + j, n - j);
+}
+
+void SubSse2(double* a, const double* b, int n) {
+  int j = 0;
+  for (; j + 2 <= n; j += 2)
+    _mm_storeu_pd(a + j, _mm_sub_pd(_mm_loadu_pd(a + j), _mm_loadu_pd(b + j)));
+  SubScalar(a + j, b + j, n - j);
+}
+
+void ScaleSse2(double* a, double num, int n) {
+  __m128d s = _mm_set1_pd(num);
+  int j = 0;
+  for (; j + 2 <= n; j += 2)
+    _mm_storeu_pd(a + j, _mm_mul_pd(_mm_loadu_pd(a + j), s));
+  ScaleScalar(a + j, num, n - j);
+}
+
+void AxpySse2(double* y, double a, const double* x, int n) {
+  __m128d s = _mm_set1_pd(a);
+  int j = 0;
+  for (; j + 2 <= n; j += 2)
+    _mm_storeu_pd(y + j, _mm_add_pd(_mm_loadu_pd(y + j),
+                                    _mm_mul_pd(s, _mm_loadu_pd(x + j))));
+  AxpyScalar(y + j, a, x + j, n - j);
+}
+
+bool EqSse2(const double* a, const double* b, int n) {
+  __m128d s = _mm_set1_pd(kEqScale);
+  int j = 0;
+  for (; j + 2 <= n; j += 2) {
+    __m128d ra = RoundSse2(_mm_mul_pd(_mm_loadu_pd(a + j), s));
+    __m128d rb = RoundSse2(_mm_mul_pd(_mm_loadu_pd(b + j), s));
+    if (_mm_movemask_pd(_mm_cmpneq_pd(ra, rb))) return false;
+  }
+  return EqScalar(a + j, b + j, n - j);
+}
+
+// With a truncating round available, std::round is trunc(x) plus one step
+// away from zero when the dropped fraction is at least one half.
+__attribute__((target("avx2"))) __m256d RoundAvx2(__m256d x) {
+  const __m256d sign = _mm256_set1_pd(-0.0);
+  __m256d t = _mm256_round_pd(x, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+  __m256d frac = _mm256_andnot_pd(sign, _mm256_sub_pd(x, t));
+  __m256d step = _mm256_or_pd(_mm256_and_pd(sign, x), _mm256_set1_pd(1.0));
+  __m256d up = _mm256_cmp_pd(frac, _mm256_set1_pd(0.5), _CMP_GE_OQ);
+  return _mm256_add_pd(t, _mm256_and_pd(up, step));
+}
+
+__attribute__((target("avx2"))) void AddAvx2(double* a, const double* b,
+                                             int n) {
+  int j = 0;
+  for (; j + 4 <= n; j += 4)
+    _mm256_storeu_pd(a + j, _mm256_add_pd(_mm256_loadu_pd(a + j),
+                                          _mm256_loadu_pd(b + j)));
+  AddScalar(a + j, b + j, n - j);
+}
+
+__attribute__((target("avx2"))) void SubAvx2(double* a, const double* b,
+                                             int n) {
+  int j = 0;
+  for (; j + 4 <= n; j += 4)
+    _mm256_storeu_pd(a + j, _mm256_sub_pd(_mm256_loadu_pd(a + j),
+                                          _mm256_loadu_pd(b + j)));
+  SubScalar(a + j, b + j, n - j);
+}
+
+__attribute__((target("avx2"))) void ScaleAvx2(double* a, double num, int n) {
+  __m256d s = _mm256_set1_pd(num);
+  int j = 0;
+  for (; j + 4 <= n; j += 4)
+    _mm256_storeu_pd(a + j, _mm256_mul_pd(_mm256_loadu_pd(a + j), s));
+  ScaleScalar(a + j, num, n - j);
+}
+
+__attribute__((target("avx2"))) void AxpyAvx2(double* y, double a,
+                                              const double* x, int n) {
+  __m256d s = _mm256_set1_pd(a);
+  int j = 0;
+  for (; j + 4 <= n; j += 4)
+    _mm256_storeu_pd(y + j,
+                     _mm256_add_pd(_mm256_loadu_pd(y + j),
+                                   _mm256_mul_pd(s, _mm256_loadu_pd(x + j))));
+  AxpyScalar(y + j, a, x + j, n - j);
+}
+
+__attribute__((target("avx2"))) bool EqAvx2(const double* a, const double* b,
+                                            int n) {
+  __m256d s = _mm256_set1_pd(kEqScale);
+  int j = 0;
+  for (; j + 4 <= n; j += 4) {
+    __m256d ra = RoundAvx2(_mm256_mul_pd(_mm256_loadu_pd(a + j), s));
+    __m256d rb = RoundAvx2(_mm256_mul_pd(_mm256_loadu_pd(b + j), s));
+    if (_mm256_movemask_pd(_mm256_cmp_pd(ra, rb, _CMP_NEQ_UQ))) return false;
+  }
+  return EqScalar(a + j, b + j, n - j);
+}
+
+__attribute__((target("avx512f"))) __m512d RoundAvx512(__m512d x) {
+  const __m512i sign = _mm512_set1_epi64(static_cast<long long>(1ULL << 63));
+  // The zero-masked form with a full mask is plain roundscale; it avoids the
+  // undefined pass-through operand that GCC 12 flags as uninitialized.
+  __m512d t = _mm512_maskz_roundscale_pd(
+      0xFF, x, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+  __m512d frac = _mm512_abs_pd(_mm512_sub_pd(x, t));
+  __m512d step = _mm512_castsi512_pd(
+      _mm512_or_si512(_mm512_and_si512(_mm512_castpd_si512(x), sign),
+                      _mm512_castpd_si512(_mm512_set1_pd(1.0))));
+  __mmask8 up = _mm512_cmp_pd_mask(frac, _mm512_set1_pd(0.5), _CMP_GE_OQ);
+  return _mm512_mask_add_pd(t, up, t, step);
+}
+
+__attribute__((target("avx512f"))) void AddAvx512(double* a, const double* b,
+                                                  int n) {
+  int j = 0;
+  for (; j + 8 <= n; j += 8)
+    _mm512_storeu_pd(a + j, _mm512_add_pd(_mm512_loadu_pd(a + j),
+                                          _mm512_loadu_pd(b + j)));
+  AddScalar(a + j, b + j, n - j);
+}
+
+__attribute__((target("avx512f"))) void SubAvx512(double* a, const double* b,
+                                                  int n) {
+  int j = 0;
+  for (; j + 8 <= n; j += 8)
+    _mm512_storeu_pd(a + j, _mm512_sub_pd(_mm512_loadu_pd(a + j),
+                                          _mm512_loadu_pd(b + j)));
+  SubScalar(a + j, b + j, n - j);
+}
+
+__attribute__((target("avx512f"))) void ScaleAvx512(double* a, double num,
+                                                    int n) {
+  __m512d s = _mm512_set1_pd(num);
+  int j = 0;
+  for (; j + 8 <= n; j += 8)
+    _mm512_storeu_pd(a + j, _mm512_mul_pd(_mm512_loadu_pd(a + j), s));
+  ScaleScalar(a + j, num, n - j);
+}
+
+__attribute__((target("avx512f"))) void AxpyAvx512(double* y, double a,
+                                                   const double* x, int n) {
+  __m512d s = _mm512_set1_pd(a);
+  int j = 0;
+  for (; j + 8 <= n; j += 8)
+    _mm512_storeu_pd(y + j,
+                     _mm512_add_pd(_mm512_loadu_pd(y + j),
+                                   _mm512_mul_pd(s, _mm512_loadu_pd(x + j))));
+  AxpyScalar(y + j, a, x + j, n - j);
+}
+
+__attribute__((target("avx512f"))) bool EqAvx512(const double* a,
+                                                 const double* b, int n) {
+  __m512d s = _mm512_set1_pd(kEqScale);
+  int j = 0;
+  for (; j + 8 <= n; j += 8) {
+    __m512d ra = RoundAvx512(_mm512_mul_pd(_mm512_loadu_pd(a + j), s));
+    __m512d rb = RoundAvx512(_mm512_mul_pd(_mm512_loadu_pd(b + j), s));
+    if (_mm512_cmp_pd_mask(ra, rb, _CMP_NEQ_UQ)) return false;
+  }
+  return EqScalar(a + j, b + j, n - j);
+}
+
+// SSE2 is part of x86-64, so its instantiations need no target attribute.
+
+template <class T>
+void AddSse2(T* a, const T* b, int n) {
+  AddVec<16>(a, b, n);
+}
+
+template <class T>
+void SubSse2(T* a, const T* b, int n) {
+  SubVec<16>(a, b, n);
+}
+
+template <class T>
+void ScaleSse2(T* a, T num, int n) {
+  ScaleVec<16>(a, num, n);
+}
+
+template <class T>
+void AxpySse2(T* y, T a, const T* x, int n) {
+  AxpyVec<16>(y, a, x, n);
+}
+
+template <class T>
+bool EqSse2(const T* a, const T* b, int n) {
+  return EqVec<16>(a, b, n);
+}
+
+// SSE2 has no 64-bit integer comparison, so ULP distances of doubles are
+// faster in scalar code.
+template <class T>
+bool NearSse2(const T* a, const T* b, int n, EqMode mode, Near<T> near) {
+  if (sizeof(T) == 8 && mode == EqMode::kUlp)
+    return NearElems<EqMode::kUlp>(a, b, n, near);
+  return NearVec<16>(a, b, n, mode, near);
+}
+
+void ComplexScaleSse2(Complex* a, Complex num, int n) {
+  ComplexScaleVec<16>(a, num, n);
+}
+
+void ComplexAxpySse2(Complex* y, Complex a, const Complex* x, int n) {
+  ComplexAxpyVec<16>(y, a, x, n);
+}
+
+template <class T>
+__attribute__((target("avx2"))) void AddAvx2(T* a, const T* b, int n) {
+  AddVec<32>(a, b, n);
+}
+
+template <class T>
+__attribute__((target("avx2"))) void SubAvx2(T* a, const T* b, int n) {
+  SubVec<32>(a, b, n);
+}
+
+template <class T>
+__attribute__((target("avx2"))) void ScaleAvx2(T* a, T num, int n) {
+  ScaleVec<32>(a, num, n);
+}
+
+template <class T>
+__attribute__((target("avx2"))) void AxpyAvx2(T* y, T a, const T* x, int n) {
+  AxpyVec<32>(y, a, x, n);
+}
+
+template <class T>
+__attribute__((target("avx2"))) bool EqAvx2(const T* a, const T* b, int n) {
+  return EqVec<32>(a, b, n);
+}
+
+template <class T>
+__attribute__((target("avx2"))) bool NearAvx2(const T* a, const T* b, int n,
+                                              EqMode mode, Near<T> near) {
+  return NearVec<32>(a, b, n, mode, near);
+}
+
+__attribute__((target("avx2"))) void ComplexScaleAvx2(Complex* a, Complex num,
+                                                      int n) {
+  ComplexScaleVec<32>(a, num, n);
+}
+
+__attribute__((target("avx2"))) void ComplexAxpyAvx2(Complex* y, Complex a,
+                                                     const Complex* x, int n) {
+  ComplexAxpyVec<32>(y, a, x, n);
+}
+
+template <class T>
+__attribute__((target("avx512f"))) void AddAvx512(T* a, const T* b, int n) {
+  AddVec<64>(a, b, n);
+}
+
+template <class T>
+__attribute__((target("avx512f"))) void SubAvx512(T* a, const T* b, int n) {
+  SubVec<64>(a, b, n);
+}
+
+template <class T>
+__attribute__((target("avx512f"))) void ScaleAvx512(T* a, T num, int n) {
+  ScaleVec<64>(a, num, n);
+}
+
+template <class T>
+__attribute__((target("avx512f"))) void AxpyAvx512(T* y, T a, const T* x,
+                                                   int n) {
+  AxpyVec<64>(y, a, x, n);
+}
+
+template <class T>
+__attribute__((target("avx512f"))) bool EqAvx512(const T* a, const T* b,
+                                                 int n) {
+  return EqVec<64>(a, b, n);
+}
+
+template <class T>
+__attribute__((target("avx512f"))) bool NearAvx512(const T* a, const T* b,
+                                                   int n, EqMode mode,
+                                                   Near<T> near) {
+  return NearVec<64>(a, b, n, mode, near);
+}
+
+__attribute__((target("avx512f"))) void ComplexScaleAvx512(Complex* a,
+                                                           Complex num,
+                                                           int n) {
+  ComplexScaleVec<64>(a, num, n);
+}
+
+__attribute__((target("avx512f"))) void ComplexAxpyAvx512(Complex* y,
+                                                          Complex a,
+                                                          const Complex* x,
+                                                          int n) {
+  ComplexAxpyVec<64>(y, a, x, n);
+}
+
+#endif  // S21_SIMD_X86
+
+template <class T>
+const Kernels<T>& KernelsFor(SimdLevel level) {
+  static const Kernels<T> scalar{AddScalar<T>, SubScalar<T>, ScaleScalar<T>,
+                                 AxpyScalar<T>, EqScalar};
+#ifdef S21_SIMD_X86
+  static const Kernels<T> sse2{AddSse2, SubSse2, ScaleSse2, AxpySse2, EqSse2};
+  static const Kernels<T> avx2{AddAvx2, SubAvx2, ScaleAvx2, AxpyAvx2, EqAvx2};
+  static const Kernels<T> avx512{AddAvx512, SubAvx512, ScaleAvx512,
+                                 AxpyAvx512, EqAvx512};
+  switch (level) {
+    case SimdLevel::kAvx512:
+      return avx512;
+    case SimdLevel::kAvx2:
+      return avx2;
+    case SimdLevel::kSse2:
+      return sse2;
+    default:
+      break;
+  }
+#endif
+  (void)level;
+  return scalar;
+}
+
+// Tolerance comparisons, for float and double only.
+template <class T>
+using NearKernel = bool (*)(const T*, const T*, int, EqMode, Near<T>);
+
+template <class T>
+NearKernel<T> NearKernelFor(SimdLevel level) {
+#ifdef S21_SIMD_X86
+  switch (level) {
+    case SimdLevel::kAvx512:
+      return NearAvx512<T>;
+    case SimdLevel::kAvx2:
+      return NearAvx2<T>;
+    case SimdLevel::kSse2:
+      return NearSse2<T>;
+    default:
+      break;
+  }
+#endif
+  (void)level;
+  return NearScalar<T>;
+}
+
+const ComplexKernels& ComplexKernelsFor(SimdLevel level) {
+  static const ComplexKernels scalar{ComplexScaleScalar, ComplexAxpyScalar};
+#ifdef S21_SIMD_X86
+  static const ComplexKernels sse2{ComplexScaleSse2, ComplexAxpySse2};
+  static const ComplexKernels avx2{ComplexScaleAvx2, ComplexAxpyAvx2};
+  static const ComplexKernels avx512{ComplexScaleAvx512, ComplexAxpyAvx512};
+  switch (level) {
+    case SimdLevel::kAvx512:
+      return avx512;
+    case SimdLevel::kAvx2:
+      return avx2;
+    case SimdLevel::kSse2:
+      return sse2;
+    default:
+      break;
+  }
+#endif
+  (void)level;
+  return scalar;
+}
+
+struct Dispatch {
+  explicit Dispatch(SimdLevel l)
+      : level(l),
+        f64(&KernelsFor<double>(l)),
+        f32(&KernelsFor<float>(l)),
+        i64(&KernelsFor<std::uint64_t>(l)),
+        c128(&ComplexKernelsFor(l)),
+        f64_near(NearKernelFor<double>(l)),
+        f32_near(NearKernelFor<float>(l)) {}
+  SimdLevel level;
+  const Kernels<double>* f64;
+  const Kernels<float>* f32;
+  // std::int64_t rows run on unsigned kernels, where overflow is defined to
+  // wrap around; the two types may alias each other.
+  const Kernels<std::uint64_t>* i64;
+  const ComplexKernels* c128;
+  NearKernel<double> f64_near;
+  NearKernel<float> f32_near;
+};
+
+std::uint64_t* Unsigned(std::int64_t* p) {
+  return reinterpret_cast<std::uint64_t*>(p);
+}
+
+const std::uint64_t* Unsigned(const std::int64_t* p) {
+  return reinterpret_cast<const std::uint64_t*>(p);
+}
+
+Dispatch& Active() {
+  static Dispatch dispatch(DetectSimdLevel());
+  return dispatch;
+}
+
+}  // namespace
+
+SimdLevel DetectSimdLevel() {
+#ifdef S21_SIMD_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) return SimdLevel::kAvx512;
+  if (__builtin_cpu_supports("avx2")) return SimdLevel::kAvx2;
+  if (__builtin_cpu_supports("sse2")) return SimdLevel::kSse2;
+#endif
+  return SimdLevel::kScalar;
+}
+
+SimdLevel ActiveSimdLevel() { return Active().level; }
+
+void SetSimdLevel(SimdLevel level) {
+  level = std::min(level, DetectSimdLevel());
+  Active() = Dispatch(level);
+}
+
+const char* SimdLevelName(SimdLevel level) {
+  switch (level) {
+    case SimdLevel::kSse2:
+      return "sse2";
+    case SimdLevel::kAvx2:
+      return "avx2";
+    case SimdLevel::kAvx512:
+      return "avx512";
+    default:
+      return "scalar";
+  }
+}
+
+void AddRow(double* a, const double* b, int n) {
+  Active().f64->add(a, b, n);
+}
+
+void SubRow(double* a, const double* b, int n) {
+  Active().f64->sub(a, b, n);
+}
+
+void ScaleRow(double* a, double num, int n) {
+  Active().f64->scale(a, num, n);
+}
+
+void AxpyRow(double* y, double a, const double* x, int n) {
+  Active().f64->axpy(y, a, x, n);
+}
+
+bool EqRow(const double* a, const double* b, int n) {
+  return Active().f64->eq(a, b, n);
+}
+
+bool NearRow(const double* a, const double* b, int n, Tolerance tolerance) {
+  return Active().f64_near(a, b, n, tolerance.mode,
+                           NearOf<double>(tolerance));
+}
+
+void AddRow(float* a, const float* b, int n) { Active().f32->add(a, b, n); }
+
+void SubRow(float* a, const float* b, int n) { Active().f32->sub(a, b, n); }
+
+void ScaleRow(float* a, float num, int n) {
+  Active().f32->scale(a, num, n);
+}
+
+void AxpyRow(float* y, float a, const float* x, int n) {
+  Active().f32->axpy(y, a, x, n);
+}
+
+bool EqRow(const float* a, const float* b, int n) {
+  return Active().f32->eq(a, b, n);
+}
+
+bool NearRow(const float* a, const float* b, int n, Tolerance tolerance) {
+  return Active().f32_near(a, b, n, tolerance.mode, NearOf<float>(tolerance));
+}
+
+void AddRow(std::int64_t* a, const std::int64_t* b, int n) {
+  Active().i64->add(Unsigned(a), Unsigned(b), n);
+}
+
+void SubRow(std::int64_t* a, const std::int64_t* b, int n) {
+  Active().i64->sub(Unsigned(a), Unsigned(b), n);
+}
+
+void ScaleRow(std::int64_t* a, std::int64_t num, int n) {
+  Active().i64->scale(Unsigned(a), num, n);
+}
+
+void AxpyRow(std::int64_t* y, std::int64_t a, const std::int64_t* x, int n) {
+  Active().i64->axpy(Unsigned(y), a, Unsigned(x), n);
+}
+
+bool EqRow(const std::int64_t* a, const std::int64_t* b, int n) {
+  return Active().i64->eq(Unsigned(a), Unsigned(b), n);
+}
+
+bool NearRow(const std::int64_t* a, const std::int64_t* b, int n,
+             Tolerance tolerance) {
+  std::uint64_t steps = Steps<std::uint64_t>(tolerance.value);
+  for (int j = 0; j < n; j++) {
+    std::uint64_t d = Distance(a[j], b[j]);
+    if (tolerance.mode != EqMode::kRelative) {
+      if (d > steps) return false;
+    } else if (!(static_cast<double>(d) <=
+                 std::max(std::fabs(static_cast<double>(a[j])),
+                          std::fabs(static_cast<double>(b[j]))) *
+                     tolerance.value)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void AddRow(Complex* a, const Complex* b, int n) {
+  AddRow(reinterpret_cast<double*>(a), reinterpret_cast<const double*>(b),
+         2 * n);
+}
+
+void SubRow(Complex* a, const Complex* b, int n) {
+  SubRow(reinterpret_cast<double*>(a), reinterpret_cast<const double*>(b),
+         2 * n);
+}
+
+void ScaleRow(Complex* a, Complex num, int n) {
+  Active().c128->scale(a, num, n);
+}
+
+void AxpyRow(Complex* y, Complex a, const Complex* x, int n) {
+  Active().c128->axpy(y, a, x, n);
+}
+
+bool EqRow(const Complex* a, const Complex* b, int n) {
+  return EqRow(reinterpret_cast<const double*>(a),
+               reinterpret_cast<const double*>(b), 2 * n);
+}
+
+bool NearRow(const Complex* a, const Complex* b, int n, Tolerance tolerance) {
+  return NearRow(reinterpret_cast<const double*>(a),
+                 reinterpret_cast<const double*>(b), 2 * n, tolerance);
+}
+
+}  // namespace s21
@@ -0,0 +1,99 @@
+#ifndef CPP1_S21_MATRIXPLUS_1_S21_SIMD_H
+#define CPP1_S21_MATRIXPLUS_1_S21_SIMD_H
+
+#include <complex>
+#include <cstdint>
+
+namespace s21 {
+
+// Instruction set levels for the element-wise kernels, in increasing order.
+enum class SimdLevel { kScalar, kSse2, kAvx2, kAvx512 };
+
+// Best level supported by this CPU and OS, from CPUID.
+[[nodiscard]] SimdLevel DetectSimdLevel();
+// Level the kernels currently dispatch to. It starts at DetectSimdLevel() and
+// can be lowered, e.g. to compare levels in benchmarks; requests above the
+// detected level are clamped. Must not be changed while kernels are running.
+[[nodiscard]] SimdLevel ActiveSimdLevel();
+void SetSimdLevel(SimdLevel level);
+[[nodiscard]] const char* SimdLevelName(SimdLevel level);
+
+enum class EqMode { kAbsolute, kRelative, kUlp };
+
+// Tolerance of an approximate comparison. Elements a and b match if
+// a == b, which admits equal infinities, or if
+//   kAbsolute: |a - b| <= value,
+//   kRelative: |a - b| <= value * max(|a|, |b|),
+//   kUlp: b is at most value steps from a through the representable
+//         numbers of the element type, with -0 and +0 one number.
+// NaN matches nothing. value must not be negative; kUlp uses its integer
+// part.
+struct Tolerance {
+  EqMode mode;
+  double value;
+
+  [[nodiscard]] static constexpr Tolerance Absolute(double value) {
+    return {EqMode::kAbsolute, value};
+  }
+  [[nodiscard]] static constexpr Tolerance Relative(double value) {
+    return {EqMode::kRelative, value};
+  }
+  [[nodiscard]] static constexpr Tolerance Ulp(double value) {
+    return {EqMode::kUlp, value};
+  }
+};
+
+// Row kernels over n contiguous elements, one set per matrix element type.
+void AddRow(double* a, const double* b, int n);  // a += b
+void SubRow(double* a, const double* b, int n);  // a -= b
+void ScaleRow(double* a, double num, int n);     // a *= num
+void AxpyRow(double* y, double a, const double* x, int n);  // y += a * x
+// True if round(a * 1e6) == round(b * 1e6) for every element, the EqMatrix
+// rule.
+[[nodiscard]] bool EqRow(const double* a, const double* b, int n);
+// True if every element pair matches under tolerance.
+[[nodiscard]] bool NearRow(const double* a, const double* b, int n,
+                           Tolerance tolerance);
+
+void AddRow(float* a, const float* b, int n);
+void SubRow(float* a, const float* b, int n);
+void ScaleRow(float* a, float num, int n);
+void AxpyRow(float* y, float a, const float* x, int n);
+// float keeps about half the digits of double, so a fixed number of decimal
+// places is too strict for large values: elements match when
+// |a - b| <= 1e-5 * max(1, |a|, |b|).
+[[nodiscard]] bool EqRow(const float* a, const float* b, int n);
+// Distances in ULPs are counted in float.
+[[nodiscard]] bool NearRow(const float* a, const float* b, int n,
+                           Tolerance tolerance);
+
+// Integer arithmetic wraps around on overflow instead of being undefined: it
+// is carried out in std::uint64_t.
+void AddRow(std::int64_t* a, const std::int64_t* b, int n);
+void SubRow(std::int64_t* a, const std::int64_t* b, int n);
+void ScaleRow(std::int64_t* a, std::int64_t num, int n);
+void AxpyRow(std::int64_t* y, std::int64_t a, const std::int64_t* x, int n);
+// Exact equality.
+[[nodiscard]] bool EqRow(const std::int64_t* a, const std::int64_t* b, int n);
+// Adjacent integers are one ULP apart, so kUlp is kAbsolute; kRelative
+// bounds are computed in double. Scalar code only.
+[[nodiscard]] bool NearRow(const std::int64_t* a, const std::int64_t* b, int n,
+                           Tolerance tolerance);
+
+// Complex products are computed as (ac - bd, ad + bc) without the C99
+// infinity and NaN recovery of std::complex's operator*.
+void AddRow(std::complex<double>* a, const std::complex<double>* b, int n);
+void SubRow(std::complex<double>* a, const std::complex<double>* b, int n);
+void ScaleRow(std::complex<double>* a, std::complex<double> num, int n);
+void AxpyRow(std::complex<double>* y, std::complex<double> a,
+             const std::complex<double>* x, int n);
+// The double rules applied to the real and imaginary parts.
+[[nodiscard]] bool EqRow(const std::complex<double>* a,
+                         const std::complex<double>* b, int n);
+[[nodiscard]] bool NearRow(const std::complex<double>* a,
+                           const std::complex<double>* b, int n,
+                           Tolerance tolerance);
+
+}  // namespace s21
+
+#endif  // CPP1_S21_MATRIXPLUS_1_S21_SIMD_H
@@ -0,0 +1,266 @@
+#include "s21_sparse_matrix.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "s21_thread_pool.h"
+
+template <class T>
+S21BasicSparseMatrix<T>::S21BasicSparseMatrix()
+    : S21BasicSparseMatrix(0, 0) {}
+
+template <class T>
+S21BasicSparseMatrix<T>::S21BasicSparseMatrix(int rows, int cols)
+    : rows_(rows), cols_(cols) {
+  if (rows < 0 || cols < 0) throw std::length_error(SIZE_MSG);
+  row_ptr_.assign(rows + 1, 0);
+}
+
+template <class T>
+S21BasicSparseMatrix<T> S21BasicSparseMatrix<T>::FromDense(
+    const_view_type m, Real tolerance) {
+  S21BasicSparseMatrix res(m.rows(), m.cols());
+  for (int i = 0; i < m.rows(); i++) {
+    for (int j = 0; j < m.cols(); j++) {
+      T a = m.At(i, j);
+      if (std::abs(a) > tolerance) {
+        res.col_idx_.push_back(j);
+        res.values_.push_back(a);
+      }
+    }
+    res.row_ptr_[i + 1] = res.nnz();
+  }
+  return res;
+}
+
+template <class T>
+S21BasicSparseMatrix<T> S21BasicSparseMatrix<T>::FromTriplets(
+    int rows, int cols, std::vector<entry_type> entries) {
+  S21BasicSparseMatrix res(rows, cols);
+  for (const entry_type& e : entries)
+    if (e.row < 0 || e.row >= rows || e.col < 0 || e.col >= cols)
+      throw std::length_error(RANGE_MSG);
+  // Stable, so duplicates are summed in the order they were given.
+  std::stable_sort(entries.begin(), entries.end(),
+                   [](const entry_type& a, const entry_type& b) {
+                     return a.row < b.row || (a.row == b.row && a.col < b.col);
+                   });
+  res.col_idx_.reserve(entries.size());
+  res.values_.reserve(entries.size());
+  for (std::size_t e = 0; e < entries.size();) {
+    int row = entries[e].row, col = entries[e].col;
+    T sum = entries[e++].value;
+    while (e < entries.size() && entries[e].row == row &&
+           entries[e].col == col)
+      sum += entries[e++].value;
+    if (sum == T(0)) continue;
+    res.col_idx_.push_back(col);
+    res.values_.push_back(sum);
+    res.row_ptr_[row + 1]++;
+  }
+  for (int i = 0; i < rows; i++) res.row_ptr_[i + 1] += res.row_ptr_[i];
+  return res;
+}
+
+template <class T>
+S21BasicMatrix<T> S21BasicSparseMatrix<T>::ToDense() const {
+  S21BasicMatrix<T> res(rows_, cols_);
+  for (int i = 0; i < rows_; i++)
+    for (int p = row_ptr_[i]; p < row_ptr_[i + 1]; p++)
+      res(i, col_idx_[p]) = values_[p];
+  return res;
+}
+
+template <class T>
+std::vector<S21SparseEntry<T>> S21BasicSparseMatrix<T>::ToTriplets() const {
+  std::vector<entry_type> res;
+  res.reserve(values_.size());
+  for (int i = 0; i < rows_; i++)
+    for (int p = row_ptr_[i]; p < row_ptr_[i + 1]; p++)
+      res.push_back({i, col_idx_[p], values_[p]});
+  return res;
+}
+
+template <class T>
+double S21BasicSparseMatrix<T>::density() const {
+  if (rows_ == 0 || cols_ == 0) return 0;
+  return static_cast<double>(nnz()) / (static_cast<double>(rows_) * cols_);
+}
+
+template <class T>
+T S21BasicSparseMatrix<T>::at(int i, int j) const {
+  if (i < 0 || i >= rows_ || j < 0 || j >= cols_)
+    throw std::length_error(RANGE_MSG);
+  auto begin = col_idx_.begin() + row_ptr_[i];
+  auto end = col_idx_.begin() + row_ptr_[i + 1];
+  auto it = std::lower_bound(begin, end, j);
+  if (it == end || *it != j) return T(0);
+  return values_[it - col_idx_.begin()];
+}
+
+template <class T>
+void S21BasicSparseMatrix<T>::Prune(Real tolerance) {
+  int out = 0;
+  for (int i = 0; i < rows_; i++) {
+    int begin = row_ptr_[i];
+    row_ptr_[i] = out;
+    for (int p = begin; p < row_ptr_[i + 1]; p++) {
+      if (std::abs(values_[p]) <= tolerance) continue;
+      col_idx_[out] = col_idx_[p];
+      values_[out++] = values_[p];
+    }
+  }
+  row_ptr_[rows_] = out;
+  col_idx_.resize(out);
+  values_.resize(out);
+}
+
+// *this += sign * other, merging the sorted rows.
+template <class T>
+void S21BasicSparseMatrix<T>::Merge(const S21BasicSparseMatrix& other,
+                                    T sign) {
+  if (rows_ != other.rows_ || cols_ != other.cols_)
+    throw std::logic_error(CORRESPOND_MSG);
+  S21BasicSparseMatrix res(rows_, cols_);
+  res.col_idx_.reserve(values_.size() + other.values_.size());
+  res.values_.reserve(values_.size() + other.values_.size());
+  auto emit = [&res](int col, T value) {
+    if (value == T(0)) return;
+    res.col_idx_.push_back(col);
+    res.values_.push_back(value);
+  };
+  for (int i = 0; i < rows_; i++) {
+    int p = row_ptr_[i], p_end = row_ptr_[i + 1];
+    int q = other.row_ptr_[i], q_end = other.row_ptr_[i + 1];
+    while (p < p_end || q < q_end) {
+      if (q == q_end || (p < p_end && col_idx_[p] < other.col_idx_[q])) {
+        emit(col_idx_[p], values_[p]);
+        p++;
+      } else if (p == p_end || other.col_idx_[q] < col_idx_[p]) {
+        emit(other.col_idx_[q], sign * other.values_[q]);
+        q++;
+      } else {
+        emit(col_idx_[p], values_[p] + sign * other.values_[q]);
+        p++;
+        q++;
+      }
+    }
+    res.row_ptr_[i + 1] = res.nnz();
+  }
+  *this = std::move(res);
+}
+
+template <class T>
+void S21BasicSparseMatrix<T>::SumMatrix(const S21BasicSparseMatrix& other) {
+  Merge(other, T(1));
+}
+
+template <class T>
+void S21BasicSparseMatrix<T>::SubMatrix(const S21BasicSparseMatrix& other) {
+  Merge(other, T(-1));
+}
+
+template <class T>
+void S21BasicSparseMatrix<T>::MulNumber(T num) {
+  if (num == T(0)) {
+    *this = S21BasicSparseMatrix(rows_, cols_);
+    return;
+  }
+  for (T& v : values_) v *= num;
+}
+
+template <class T>
+S21BasicSparseMatrix<T> S21BasicSparseMatrix<T>::Transpose() const {
+  S21BasicSparseMatrix res(cols_, rows_);
+  res.col_idx_.resize(values_.size());
+  res.values_.resize(values_.size());
+  // Counting sort by column; walking the rows in order leaves every
+  // transposed row sorted.
+  for (int c : col_idx_) res.row_ptr_[c + 1]++;
+  for (int j = 0; j < cols_; j++) res.row_ptr_[j + 1] += res.row_ptr_[j];
+  std::vector<int> next(res.row_ptr_.begin(), res.row_ptr_.end() - 1);
+  for (int i = 0; i < rows_; i++)
+    for (int p = row_ptr_[i]; p < row_ptr_[i + 1]; p++) {
+      int q = next[col_idx_[p]]++;
+      res.col_idx_[q] = i;
+      res.values_[q] = values_[p];
+    }
+  return res;
+}
+
+template <class T>
+void S21BasicSparseMatrix<T>::MulVector(S21Span<const T> x,
+                                        S21Span<T> y) const {
+  if (x.size() != cols_ || y.size() != rows_)
+    throw std::logic_error(CORRESPOND_MSG);
+  long cost = rows_ > 0 ? nnz() / rows_ + 1 : 1;
+  s21::ParallelFor(rows_, cost, [&](int begin, int end) {
+    for (int i = begin; i < end; i++) {
+      T sum = T(0);
+      for (int p = row_ptr_[i]; p < row_ptr_[i + 1]; p++)
+        sum += values_[p] * x[col_idx_[p]];
+      y[i] = sum;
+    }
+  });
+}
+
+template <class T>
+std::vector<T> S21BasicSparseMatrix<T>::MulVector(S21Span<const T> x) const {
+  std::vector<T> y(rows_);
+  MulVector(x, S21Span<T>(y.data(), rows_));
+  return y;
+}
+
+template <class T>
+S21BasicMatrix<T> S21BasicSparseMatrix<T>::MulDense(const_view_type m) const {
+  if (cols_ != m.rows()) throw std::logic_error(CORRESPOND_MSG);
+  // Minors are copied once so the inner loop can walk plain strides.
+  S21BasicMatrix<T> tmp;
+  if (!m.strided()) {
+    tmp = m;
+    m = tmp;
+  }
+  S21BasicMatrix<T> res(rows_, m.cols());
+  int n = m.cols(), rs = m.row_stride(), cs = m.col_stride();
+  long cost = (rows_ > 0 ? nnz() / rows_ + 1 : 1) * static_cast<long>(n);
+  s21::ParallelFor(rows_, cost, [&](int begin, int end) {
+    for (int i = begin; i < end; i++) {
+      T* out = res.row(i).data();
+      for (int p = row_ptr_[i]; p < row_ptr_[i + 1]; p++) {
+        T a = values_[p];
+        const T* in = m.data() + static_cast<std::ptrdiff_t>(col_idx_[p]) * rs;
+        if (cs == 1) {
+          for (int j = 0; j < n; j++) out[j] += a * in[j];
+        } else {
+          for (int j = 0; j < n; j++) out[j] += a * in[j * cs];
+        }
+      }
+    }
+  });
+  return res;
+}
+
+template <class T>
+S21BasicSparseMatrix<T>& S21BasicSparseMatrix<T>::operator+=(
+    const S21BasicSparseMatrix& other) {
+  SumMatrix(other);
+  return *this;
+}
+
+template <class T>
+S21BasicSparseMatrix<T>& S21BasicSparseMatrix<T>::operator-=(
+    const S21BasicSparseMatrix& other) {
+  SubMatrix(other);
+  return *this;
+}
+
+template <class T>
+S21BasicSparseMatrix<T>& S21BasicSparseMatrix<T>::operator*=(T num) {
+  MulNumber(num);
+  return *this;
+}
+
+template class S21BasicSparseMatrix<float>;
+template class S21BasicSparseMatrix<double>;
+template class S21BasicSparseMatrix<std::int64_t>;
+template class S21BasicSparseMatrix<std::complex<double>>;
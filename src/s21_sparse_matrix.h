@@ -0,0 +1,116 @@
+#ifndef CPP1_S21_MATRIXPLUS_1_S21_SPARSE_MATRIX_H
+#define CPP1_S21_MATRIXPLUS_1_S21_SPARSE_MATRIX_H
+
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+// Coordinate (COO) entry, the input and output format of the triplet
+// conversions below.
+template <class T>
+struct S21SparseEntry {
+  int row, col;
+  T value;
+};
+
+// rows() x cols() matrix in compressed sparse row (CSR) form: the non-zeros
+// of row i are values()[row_ptr()[i] .. row_ptr()[i + 1]), at the columns
+// col_idx() of the same range, sorted ascending with no duplicates. Storage
+// is O(rows + nnz) and every operation below runs in O(rows + nnz) plus the
+// size of its dense operand or result, never rows * cols.
+//
+// Entries that become exactly zero in a sum are dropped; the conversions
+// from dense and triplet form drop zeros as well, and FromDense and Prune
+// take a tolerance to sparsify near-zero values. Which form is faster depends
+// on density(): a 2048 x 2048 times 2048 x 64 product is still faster sparse
+// at 30% density (benchmarks/s21_sparse_bench.cc), beyond that ToDense()
+// and the S21BasicMatrix operations win. Instantiated for the S21BasicMatrix
+// element types.
+template <class T>
+class S21BasicSparseMatrix {
+ public:
+  using value_type = T;
+  using entry_type = S21SparseEntry<T>;
+  using const_view_type = S21BasicMatrixView<const T>;
+  // Magnitude type of the tolerances: double for std::complex<double>.
+  using Real = decltype(std::abs(T()));
+
+  S21BasicSparseMatrix();
+  // rows x cols matrix of zeros.
+  S21BasicSparseMatrix(int rows, int cols);
+
+  // Elements of m with magnitude above tolerance.
+  [[nodiscard]] static S21BasicSparseMatrix FromDense(const_view_type m,
+                                                      Real tolerance = 0);
+  // Entries in any order; duplicates are summed. Throws std::length_error
+  // for entries outside rows x cols.
+  [[nodiscard]] static S21BasicSparseMatrix FromTriplets(
+      int rows, int cols, std::vector<entry_type> entries);
+  [[nodiscard]] S21BasicMatrix<T> ToDense() const;
+  // Non-zeros in row-major order.
+  [[nodiscard]] std::vector<entry_type> ToTriplets() const;
+
+  [[nodiscard]] int rows() const { return rows_; }
+  [[nodiscard]] int cols() const { return cols_; }
+  [[nodiscard]] int nnz() const { return static_cast<int>(values_.size()); }
+  // nnz() / (rows() * cols()), zero for an empty shape.
+  [[nodiscard]] double density() const;
+  [[nodiscard]] const int* row_ptr() const { return row_ptr_.data(); }
+  [[nodiscard]] const int* col_idx() const { return col_idx_.data(); }
+  [[nodiscard]] const T* values() const { return values_.data(); }
+
+  // Element (i, j), zero if it is not stored; O(log nnz of row i). Throws
+  // std::length_error outside the matrix.
+  [[nodiscard]] T at(int i, int j) const;
+  // Drops the stored elements of magnitude at or below tolerance.
+  void Prune(Real tolerance = 0);
+
+  void SumMatrix(const S21BasicSparseMatrix& other);
+  void SubMatrix(const S21BasicSparseMatrix& other);
+  void MulNumber(T num);
+  [[nodiscard]] S21BasicSparseMatrix Transpose() const;
+  // y = *this * x, with x of cols() and y of rows() elements; y must not
+  // overlap x. The second form allocates y.
+  void MulVector(S21Span<const T> x, S21Span<T> y) const;
+  [[nodiscard]] std::vector<T> MulVector(S21Span<const T> x) const;
+  // *this * m as a dense rows() x m.cols() matrix.
+  [[nodiscard]] S21BasicMatrix<T> MulDense(const_view_type m) const;
+
+  friend S21BasicSparseMatrix operator+(S21BasicSparseMatrix l,
+                                        const S21BasicSparseMatrix& r) {
+    l.SumMatrix(r);
+    return l;
+  }
+  friend S21BasicSparseMatrix operator-(S21BasicSparseMatrix l,
+                                        const S21BasicSparseMatrix& r) {
+    l.SubMatrix(r);
+    return l;
+  }
+  friend S21BasicMatrix<T> operator*(const S21BasicSparseMatrix& l,
+                                     const_view_type r) {
+    return l.MulDense(r);
+  }
+  S21BasicSparseMatrix& operator+=(const S21BasicSparseMatrix& other);
+  S21BasicSparseMatrix& operator-=(const S21BasicSparseMatrix& other);
+  S21BasicSparseMatrix& operator*=(T num);
+
+ private:
+  void Merge(const S21BasicSparseMatrix& other, T sign);
+
+  int rows_, cols_;
+  std::vector<int> row_ptr_;
+  std::vector<int> col_idx_;
+  std::vector<T> values_;
+};
+
+using S21SparseMatrix = S21BasicSparseMatrix<double>;
+using S21FloatSparseMatrix = S21BasicSparseMatrix<float>;
+using S21Int64SparseMatrix = S21BasicSparseMatrix<std::int64_t>;
+using S21ComplexSparseMatrix = S21BasicSparseMatrix<std::complex<double>>;
+
+extern template class S21BasicSparseMatrix<float>;
+extern template class S21BasicSparseMatrix<double>;
+extern template class S21BasicSparseMatrix<std::int64_t>;
+extern template class S21BasicSparseMatrix<std::complex<double>>;
+
+#endif  // CPP1_S21_MATRIXPLUS_1_S21_SPARSE_MATRIX_H
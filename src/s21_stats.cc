@@ -0,0 +1,229 @@
+#include "s21_stats.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdarg>
+#include <cstdio>
+
+namespace s21 {
+
+namespace {
+
+struct AtomicOpStats {
+  std::atomic<long> calls, total_ns, max_ns, matrices, matrix_bytes;
+  std::atomic<long> histogram[kLatencyBuckets];
+};
+
+AtomicOpStats op_stats[kOpCount][kOpSizeClasses];
+std::atomic<long> all_matrices{0};
+std::atomic<long> all_matrix_bytes{0};
+std::atomic<long> deep_copies{0};
+std::atomic<long> copied_bytes{0};
+std::atomic<long> moves{0};
+
+// Per-thread allocation totals, so an OpTimer can tell what its own
+// operation allocated.
+thread_local long thread_matrices = 0;
+thread_local long thread_matrix_bytes = 0;
+
+constexpr const char* kOpNames[kOpCount] = {
+    "EqMatrix", "SumMatrix",       "SubMatrix",   "MulNumber",
+    "Product",  "Gemm",            "Axpy",        "Transpose",
+    "CalcComplements", "Determinant", "InverseMatrix", "EvalExpr",
+    "Solve"};
+constexpr const char* kSizeClassNames[kOpSizeClasses] = {
+    "<=4", "<=16", "<=64", "<=256", "<=1024", ">1024"};
+
+void Add(std::atomic<long>& counter, long value) {
+  counter.fetch_add(value, std::memory_order_relaxed);
+}
+
+long Get(const std::atomic<long>& counter) {
+  return counter.load(std::memory_order_relaxed);
+}
+
+int LatencyBucket(long ns) {
+  int b = 0;
+  while (b + 1 < kLatencyBuckets && ns >> (b + 1) != 0) b++;
+  return b;
+}
+
+// Upper bound of the bucket holding the calls up to fraction q of all.
+long Percentile(const OpStats& s, double q) {
+  long seen = 0;
+  for (int b = 0; b < kLatencyBuckets; b++) {
+    seen += s.histogram[b];
+    if (seen >= q * s.calls) return 2L << b;
+  }
+  return s.max_ns;
+}
+
+std::string Format(const char* format, ...)
+    __attribute__((format(printf, 1, 2)));
+
+std::string Format(const char* format, ...) {
+  char buf[256];
+  va_list args;
+  va_start(args, format);
+  std::vsnprintf(buf, sizeof(buf), format, args);
+  va_end(args);
+  return buf;
+}
+
+}  // namespace
+
+bool StatsEnabled() {
+#ifdef S21_STATS
+  return true;
+#else
+  return false;
+#endif
+}
+
+StatsSnapshot GetStats() {
+  StatsSnapshot res{};
+  for (int op = 0; op < kOpCount; op++)
+    for (int c = 0; c < kOpSizeClasses; c++) {
+      const AtomicOpStats& from = op_stats[op][c];
+      OpStats& to = res.ops[op][c];
+      to.calls = Get(from.calls);
+      to.total_ns = Get(from.total_ns);
+      to.max_ns = Get(from.max_ns);
+      to.matrices = Get(from.matrices);
+      to.matrix_bytes = Get(from.matrix_bytes);
+      for (int b = 0; b < kLatencyBuckets; b++)
+        to.histogram[b] = Get(from.histogram[b]);
+    }
+  res.matrices = Get(all_matrices);
+  res.matrix_bytes = Get(all_matrix_bytes);
+  res.deep_copies = Get(deep_copies);
+  res.copied_bytes = Get(copied_bytes);
+  res.moves = Get(moves);
+  return res;
+}
+
+void ResetStats() {
+  for (auto& row : op_stats)
+    for (AtomicOpStats& s : row) {
+      s.calls = 0;
+      s.total_ns = 0;
+      s.max_ns = 0;
+      s.matrices = 0;
+      s.matrix_bytes = 0;
+      for (auto& b : s.histogram) b = 0;
+    }
+  all_matrices = 0;
+  all_matrix_bytes = 0;
+  deep_copies = 0;
+  copied_bytes = 0;
+  moves = 0;
+}
+
+std::string StatsText(const StatsSnapshot& stats) {
+  std::string res = Format(
+      "matrices %ld (%ld bytes), deep copies %ld (%ld bytes), moves %ld\n",
+      stats.matrices, stats.matrix_bytes, stats.deep_copies,
+      stats.copied_bytes, stats.moves);
+  res += Format("%-16s %-7s %10s %12s %10s %10s %10s %10s %9s\n", "op",
+                "size", "calls", "total_us", "mean_us", "p50_us", "p99_us",
+                "max_us", "matrices");
+  for (int op = 0; op < kOpCount; op++)
+    for (int c = 0; c < kOpSizeClasses; c++) {
+      const OpStats& s = stats.ops[op][c];
+      if (s.calls == 0) continue;
+      res += Format(
+          "%-16s %-7s %10ld %12.1f %10.3f %10.3f %10.3f %10.3f %9ld\n",
+          kOpNames[op], kSizeClassNames[c], s.calls, s.total_ns / 1e3,
+          s.total_ns / 1e3 / s.calls, Percentile(s, 0.5) / 1e3,
+          Percentile(s, 0.99) / 1e3, s.max_ns / 1e3, s.matrices);
+    }
+  return res;
+}
+
+std::string StatsJson(const StatsSnapshot& stats) {
+  std::string res = Format(
+      "{\"enabled\":%s,\"matrices\":%ld,\"matrix_bytes\":%ld,"
+      "\"deep_copies\":%ld,\"copied_bytes\":%ld,\"moves\":%ld,"
+      "\"operations\":[",
+      StatsEnabled() ? "true" : "false", stats.matrices, stats.matrix_bytes,
+      stats.deep_copies, stats.copied_bytes, stats.moves);
+  bool first = true;
+  for (int op = 0; op < kOpCount; op++)
+    for (int c = 0; c < kOpSizeClasses; c++) {
+      const OpStats& s = stats.ops[op][c];
+      if (s.calls == 0) continue;
+      res += Format(
+          "%s{\"op\":\"%s\",\"size\":\"%s\",\"calls\":%ld,\"total_ns\":%ld,"
+          "\"max_ns\":%ld,\"matrices\":%ld,\"matrix_bytes\":%ld,"
+          "\"histogram_ns\":{",
+          first ? "" : ",", kOpNames[op], kSizeClassNames[c], s.calls,
+          s.total_ns, s.max_ns, s.matrices, s.matrix_bytes);
+      first = false;
+      // Keyed by the lower bound of each non-empty bucket.
+      bool first_bucket = true;
+      for (int b = 0; b < kLatencyBuckets; b++) {
+        if (s.histogram[b] == 0) continue;
+        res += Format("%s\"%ld\":%ld", first_bucket ? "" : ",",
+                      b == 0 ? 0L : 1L << b, s.histogram[b]);
+        first_bucket = false;
+      }
+      res += "}}";
+    }
+  return res + "]}";
+}
+
+const char* OpName(Op op) { return kOpNames[static_cast<int>(op)]; }
+
+int OpSizeClass(int rows, int cols) {
+  int n = std::max(rows, cols), c = 0;
+  for (int bound = 4; c + 1 < kOpSizeClasses && n > bound; bound *= 4) c++;
+  return c;
+}
+
+const char* OpSizeClassName(int size_class) {
+  return kSizeClassNames[size_class];
+}
+
+void RecordOp(Op op, int size_class, long ns, long matrices,
+              long matrix_bytes) {
+  AtomicOpStats& s = op_stats[static_cast<int>(op)][size_class];
+  Add(s.calls, 1);
+  Add(s.total_ns, ns);
+  Add(s.matrices, matrices);
+  Add(s.matrix_bytes, matrix_bytes);
+  Add(s.histogram[LatencyBucket(ns)], 1);
+  long max = Get(s.max_ns);
+  while (ns > max && !s.max_ns.compare_exchange_weak(max, ns)) {
+  }
+}
+
+void RecordAllocation(std::size_t bytes) {
+  thread_matrices++;
+  thread_matrix_bytes += static_cast<long>(bytes);
+  Add(all_matrices, 1);
+  Add(all_matrix_bytes, static_cast<long>(bytes));
+}
+
+void RecordCopy(std::size_t bytes) {
+  Add(deep_copies, 1);
+  Add(copied_bytes, static_cast<long>(bytes));
+}
+
+void RecordMove() { Add(moves, 1); }
+
+OpTimer::OpTimer(Op op, int rows, int cols)
+    : op_(op),
+      size_class_(OpSizeClass(rows, cols)),
+      matrices_(thread_matrices),
+      matrix_bytes_(thread_matrix_bytes),
+      start_(std::chrono::steady_clock::now()) {}
+
+OpTimer::~OpTimer() {
+  auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start_)
+                .count();
+  RecordOp(op_, size_class_, static_cast<long>(ns),
+           thread_matrices - matrices_, thread_matrix_bytes - matrix_bytes_);
+}
+
+}  // namespace s21
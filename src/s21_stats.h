@@ -0,0 +1,115 @@
+#ifndef CPP1_S21_MATRIXPLUS_1_S21_STATS_H
+#define CPP1_S21_MATRIXPLUS_1_S21_STATS_H
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+// Opt-in instrumentation of the S21BasicMatrix operations. Building with
+// S21_STATS defined (`make STATS=1`) turns the S21_STATS_* hooks in the
+// matrix code into calls that count and time every operation; without it
+// they compile to nothing and the snapshot stays empty. The macro must be
+// the same for the library and for the code that includes its headers,
+// since expression evaluation is instantiated there.
+namespace s21 {
+
+// Timed operations. kProduct covers MulMatrix and operator*, kEvalExpr the
+// evaluation of lazy element-wise expressions such as a + b * 2.
+enum class Op {
+  kEqMatrix,
+  kSumMatrix,
+  kSubMatrix,
+  kMulNumber,
+  kProduct,
+  kGemm,
+  kAxpy,
+  kTranspose,
+  kCalcComplements,
+  kDeterminant,
+  kInverseMatrix,
+  kEvalExpr,
+  kSolve,
+};
+constexpr int kOpCount = 13;
+// Operations are binned by their larger dimension: up to 4, 16, 64, 256,
+// 1024 and above.
+constexpr int kOpSizeClasses = 6;
+// Latency bucket b counts calls that took [2^b, 2^(b + 1)) nanoseconds;
+// bucket 0 also takes calls under a nanosecond.
+constexpr int kLatencyBuckets = 40;
+
+struct OpStats {
+  long calls;
+  long total_ns;
+  long max_ns;
+  // Matrices allocated on the calling thread while the operation ran,
+  // including those of nested operations, and their bytes.
+  long matrices;
+  long matrix_bytes;
+  long histogram[kLatencyBuckets];
+};
+
+struct StatsSnapshot {
+  OpStats ops[kOpCount][kOpSizeClasses];
+  // Matrix storage allocations, copies by the copy constructor and copy
+  // assignment, and moves, process-wide.
+  long matrices;
+  long matrix_bytes;
+  long deep_copies;
+  long copied_bytes;
+  long moves;
+};
+
+// True if the library was built with S21_STATS.
+[[nodiscard]] bool StatsEnabled();
+// Counts since the last reset. Updates from other threads that overlap the
+// call may be partly included.
+[[nodiscard]] StatsSnapshot GetStats();
+void ResetStats();
+// Human-readable table and JSON document of the non-empty entries; latency
+// percentiles are upper bounds of their histogram bucket.
+[[nodiscard]] std::string StatsText(const StatsSnapshot& stats);
+[[nodiscard]] std::string StatsJson(const StatsSnapshot& stats);
+
+[[nodiscard]] const char* OpName(Op op);
+[[nodiscard]] int OpSizeClass(int rows, int cols);
+[[nodiscard]] const char* OpSizeClassName(int size_class);
+
+// Recording entry points behind the hooks; all of them are thread-safe.
+void RecordOp(Op op, int size_class, long ns, long matrices,
+              long matrix_bytes);
+void RecordAllocation(std::size_t bytes);
+void RecordCopy(std::size_t bytes);
+void RecordMove();
+
+// Times the enclosing scope as one call of op.
+class OpTimer {
+ public:
+  OpTimer(Op op, int rows, int cols);
+  OpTimer(const OpTimer&) = delete;
+  OpTimer& operator=(const OpTimer&) = delete;
+  ~OpTimer();
+
+ private:
+  Op op_;
+  int size_class_;
+  long matrices_, matrix_bytes_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+}  // namespace s21
+
+#ifdef S21_STATS
+#define S21_STATS_OP(op, rows, cols) \
+  ::s21::OpTimer s21_stats_timer_(::s21::Op::op, rows, cols)
+#define S21_STATS_ALLOCATION(bytes) ::s21::RecordAllocation(bytes)
+#define S21_STATS_COPY(bytes) ::s21::RecordCopy(bytes)
+#define S21_STATS_MOVE() ::s21::RecordMove()
+#else
+#define S21_STATS_OP(op, rows, cols) ((void)0)
+#define S21_STATS_ALLOCATION(bytes) ((void)0)
+#define S21_STATS_COPY(bytes) ((void)0)
+#define S21_STATS_MOVE() ((void)0)
+#endif
+
+#endif  // CPP1_S21_MATRIXPLUS_1_S21_STATS_H
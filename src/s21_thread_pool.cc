@@ -0,0 +1,167 @@
+#include "s21_thread_pool.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace s21 {
+
+namespace {
+
+thread_local bool in_pool_task = false;
+
+std::unique_ptr<ThreadPool>& PoolInstance() {
+  static std::unique_ptr<ThreadPool> pool;
+  return pool;
+}
+
+// Guards PoolInstance() between Pool() and SetNumThreads().
+std::mutex& PoolMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+int DefaultThreads() {
+  return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+}
+
+}  // namespace
+
+ThreadPool::ThreadPool(int threads)
+    : body_(nullptr),
+      remaining_(0),
+      failed_(false),
+      generation_(0),
+      busy_(0),
+      stop_(false) {
+  threads = std::max(1, threads);
+  for (int i = 0; i < threads; i++)
+    queues_.push_back(std::make_unique<Queue>());
+  for (int i = 1; i < threads; i++)
+    workers_.emplace_back(&ThreadPool::WorkerLoop, this, i);
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  wake_.notify_all();
+  for (auto& worker : workers_) worker.join();
+}
+
+int ThreadPool::size() const { return static_cast<int>(queues_.size()); }
+
+void ThreadPool::Run(int tasks, FunctionRef<void(int)> body) {
+  if (tasks <= 0) return;
+  if (size() == 1 || tasks == 1 || in_pool_task) {
+    for (int i = 0; i < tasks; i++) body(i);
+    return;
+  }
+  std::lock_guard<std::mutex> run_lock(run_mutex_);
+  // body_ is published before any task becomes visible: a worker still
+  // draining after the previous Run() may pick up the new tasks right away.
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    body_ = &body;
+    remaining_ = tasks;
+    failed_ = false;
+    error_ = nullptr;
+  }
+  int n = size();
+  for (int q = 0; q < n; q++) {
+    std::lock_guard<std::mutex> lock(queues_[q]->mutex);
+    queues_[q]->front = tasks * q / n;
+    queues_[q]->back = tasks * (q + 1) / n;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    generation_++;
+  }
+  wake_.notify_all();
+  Drain(0);
+  std::unique_lock<std::mutex> lock(mutex_);
+  done_.wait(lock, [this] { return remaining_ == 0 && busy_ == 0; });
+  if (failed_) std::rethrow_exception(std::exchange(error_, nullptr));
+}
+
+void ThreadPool::WorkerLoop(int id) {
+  unsigned seen = 0;
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+      if (stop_) return;
+      seen = generation_;
+      busy_++;
+    }
+    Drain(id);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      busy_--;
+    }
+    done_.notify_all();
+  }
+}
+
+// Own queue from the front, then the other queues from the back.
+bool ThreadPool::TakeTask(int id, int& task) {
+  int n = size();
+  for (int k = 0; k < n; k++) {
+    Queue& queue = *queues_[(id + k) % n];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.front == queue.back) continue;
+    task = k == 0 ? queue.front++ : --queue.back;
+    return true;
+  }
+  return false;
+}
+
+void ThreadPool::Drain(int id) {
+  int task;
+  in_pool_task = true;
+  while (TakeTask(id, task)) {
+    // After a failure the remaining tasks are only counted off.
+    if (!failed_) {
+      try {
+        (*body_)(task);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!failed_) error_ = std::current_exception();
+        failed_ = true;
+      }
+    }
+    remaining_--;
+  }
+  in_pool_task = false;
+}
+
+ThreadPool& Pool() {
+  std::lock_guard<std::mutex> lock(PoolMutex());
+  auto& pool = PoolInstance();
+  if (!pool) pool = std::make_unique<ThreadPool>(DefaultThreads());
+  return *pool;
+}
+
+void SetNumThreads(int threads) {
+  if (threads < 1) threads = DefaultThreads();
+  std::lock_guard<std::mutex> lock(PoolMutex());
+  auto& pool = PoolInstance();
+  if (pool && pool->size() == threads) return;
+  pool.reset();
+  pool = std::make_unique<ThreadPool>(threads);
+}
+
+int NumThreads() { return Pool().size(); }
+
+int ParallelChunks(int count, long cost) {
+  int threads = Pool().size();
+  long work = static_cast<long>(count) * std::max(1L, cost);
+  if (threads == 1 || work < kParallelWork) return 1;
+  // A few chunks per thread leave room for stealing, but never chunks so
+  // small that scheduling them costs more than the work itself.
+  long max_chunks = std::max(1L, work / (kParallelWork / 4));
+  return static_cast<int>(
+      std::min<long>({count, 4L * threads, max_chunks}));
+}
+
+}  // namespace s21
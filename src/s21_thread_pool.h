@@ -0,0 +1,122 @@
+#ifndef CPP1_S21_MATRIXPLUS_1_S21_THREAD_POOL_H
+#define CPP1_S21_MATRIXPLUS_1_S21_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace s21 {
+
+// Non-owning reference to a callable, for bodies that only have to live as
+// long as the call they are passed to. Unlike std::function it never copies
+// the callable, so passing a lambda with any captures does not allocate.
+template <class Signature>
+class FunctionRef;
+
+template <class R, class... Args>
+class FunctionRef<R(Args...)> {
+ public:
+  template <class F, class = std::enable_if_t<
+                         !std::is_same_v<std::decay_t<F>, FunctionRef>>>
+  FunctionRef(F&& f)  // NOLINT(google-explicit-constructor)
+      : object_(const_cast<void*>(
+            static_cast<const void*>(std::addressof(f)))),
+        call_([](void* object, Args... args) -> R {
+          return (*static_cast<std::remove_reference_t<F>*>(object))(
+              std::forward<Args>(args)...);
+        }) {}
+
+  R operator()(Args... args) const {
+    return call_(object_, std::forward<Args>(args)...);
+  }
+
+ private:
+  void* object_;
+  R (*call_)(void*, Args...);
+};
+
+// Fixed set of worker threads shared by all matrix operations. Each Run()
+// hands the tasks out in contiguous runs, one queue per participant (the
+// calling thread included); a participant that runs dry steals from the back
+// of the other queues. Every task is executed by exactly one thread, so the
+// result of a task never depends on how many threads took part. Run() does
+// not allocate.
+class ThreadPool {
+ public:
+  explicit ThreadPool(int threads);
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+  ~ThreadPool();
+
+  // Number of threads that take part in Run(), the caller included.
+  [[nodiscard]] int size() const;
+  // Calls body(i) for every i in [0, tasks) and returns once all are done.
+  // Calls made from inside a task run inline. If body throws, tasks not yet
+  // started are skipped and the first exception is rethrown once every
+  // thread has left the run.
+  void Run(int tasks, FunctionRef<void(int)> body);
+
+ private:
+  // The tasks [front, back) still waiting in one participant's run.
+  struct Queue {
+    std::mutex mutex;
+    int front = 0;
+    int back = 0;
+  };
+
+  void WorkerLoop(int id);
+  bool TakeTask(int id, int& task);
+  void Drain(int id);
+
+  std::vector<std::thread> workers_;
+  std::vector<std::unique_ptr<Queue>> queues_;
+  std::mutex run_mutex_;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable done_;
+  const FunctionRef<void(int)>* body_;
+  std::atomic<int> remaining_;
+  std::atomic<bool> failed_;
+  std::exception_ptr error_;
+  unsigned generation_;
+  int busy_;
+  bool stop_;
+};
+
+// Library-wide pool. The thread count defaults to the hardware concurrency;
+// 1 runs everything on the calling thread. Changing it must not overlap with
+// running matrix operations; creating the pool on first use is thread-safe.
+ThreadPool& Pool();
+void SetNumThreads(int threads);
+[[nodiscard]] int NumThreads();
+
+// Splits [0, count) into contiguous chunks and runs body(begin, end) for each
+// on the pool once count * cost reaches kParallelWork; smaller jobs run as a
+// single body(0, count) call on the caller, without going through the pool.
+constexpr long kParallelWork = 1L << 16;
+// Number of chunks ParallelFor() cuts such a job into; 1 runs it inline.
+[[nodiscard]] int ParallelChunks(int count, long cost);
+
+template <class F>
+void ParallelFor(int count, long cost, F&& body) {
+  if (count <= 0) return;
+  int chunks = ParallelChunks(count, cost);
+  if (chunks == 1) {
+    body(0, count);
+    return;
+  }
+  Pool().Run(chunks, [&](int c) {
+    body(static_cast<int>(static_cast<long>(count) * c / chunks),
+         static_cast<int>(static_cast<long>(count) * (c + 1) / chunks));
+  });
+}
+
+}  // namespace s21
+
+#endif  // CPP1_S21_MATRIXPLUS_1_S21_THREAD_POOL_H
@@ -1,6 +1,83 @@
 #include "../s21_matrix_oop.h"
 
 #include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <complex>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "../s21_allocator.h"
+#include "../s21_fixed_matrix.h"
+#include "../s21_gemm.h"
+#include "../s21_matrix_batch.h"
+#include "../s21_matrix_io.h"
+#include "../s21_out_of_core.h"
+#include "../s21_simd.h"
+#include "../s21_sparse_matrix.h"
+#include "../s21_stats.h"
+#include "../s21_thread_pool.h"
+
+// Every global operator new is counted, so tests can check that a warmed-up
+// operation does not allocate behind s21::Allocator's back.
+namespace {
+std::atomic<long> global_news{0};
+}  // namespace
+
+void* operator new(std::size_t bytes) {
+  global_news.fetch_add(1, std::memory_order_relaxed);
+  if (void* p = std::malloc(bytes > 0 ? bytes : 1)) return p;
+  throw std::bad_alloc();
+}
+
+void* operator new(std::size_t bytes, std::align_val_t align) {
+  global_news.fetch_add(1, std::memory_order_relaxed);
+  std::size_t a = static_cast<std::size_t>(align);
+  if (void* p = std::aligned_alloc(a, (bytes + a - 1) / a * a)) return p;
+  throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t bytes) { return operator new(bytes); }
+void* operator new[](std::size_t bytes, std::align_val_t align) {
+  return operator new(bytes, align);
+}
+
+void* operator new(std::size_t bytes, const std::nothrow_t&) noexcept {
+  global_news.fetch_add(1, std::memory_order_relaxed);
+  return std::malloc(bytes > 0 ? bytes : 1);
+}
+void* operator new[](std::size_t bytes, const std::nothrow_t& t) noexcept {
+  return operator new(bytes, t);
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept {
+  std::free(p);
+}
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+  std::free(p);
+}
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept {
+  std::free(p);
+}
 
 TEST(S21MatrixTest, RowsSetter) {
   S21Matrix A(2, 2);
@@ -28,6 +105,93 @@ TEST(S21MatrixTest, ColsSetter) {
   ASSERT_THROW(A.set_cols(-2), std::length_error);
 }
 
+TEST(S21MatrixTest, ResizeInPlace) {
+  S21Matrix A(3, 4);
+  for (int k = 0; k < 12; k++) A(k / 4, k % 4) = k + 1;
+  const double *p = A.data();
+  A.set_rows(2);
+  A.set_cols(2);
+  EXPECT_EQ(A.data(), p);
+  EXPECT_EQ(A.row_capacity(), 3);
+  EXPECT_EQ(A.col_capacity(), 4);
+  // Regrowing within the capacity zero-fills instead of exposing old values.
+  A.set_rows(3);
+  A.set_cols(3);
+  EXPECT_EQ(A.data(), p);
+  double exp[3][3] = {{1, 2, 0}, {5, 6, 0}, {0, 0, 0}};
+  for (int i = 0; i < 3; i++)
+    for (int j = 0; j < 3; j++) EXPECT_EQ(A(i, j), exp[i][j]);
+  ASSERT_NE(A.matrix(), nullptr);
+  for (int i = 0; i < 3; i++) EXPECT_EQ(A.matrix()[i], &A(i, 0));
+
+  // Padded rows work with every operation.
+  S21Matrix B(3, 3);
+  for (int i = 0; i < 3; i++)
+    for (int j = 0; j < 3; j++) B(i, j) = exp[i][j] + (i == j ? 1 : 0);
+  A(2, 2) = 1;
+  S21Matrix C = A;
+  EXPECT_EQ(C.col_capacity(), 3);
+  EXPECT_TRUE(A == C);
+  EXPECT_TRUE(A * B == C * B);
+  EXPECT_TRUE(A.Transpose() == C.Transpose());
+  EXPECT_DOUBLE_EQ(A.Determinant(), C.Determinant());
+  EXPECT_TRUE(A.InverseMatrix() == C.InverseMatrix());
+  A += B;
+  EXPECT_TRUE(A == C + B);
+
+  A.reserve(8, 5);
+  EXPECT_EQ(A.rows(), 3);
+  EXPECT_EQ(A.row_capacity(), 8);
+  EXPECT_EQ(A.col_capacity(), 5);
+  EXPECT_TRUE(A == C + B);
+  p = A.data();
+  A.set_rows(8);
+  A.set_cols(5);
+  EXPECT_EQ(A.data(), p);
+  A.reserve(1, 1);
+  EXPECT_EQ(A.row_capacity(), 8);
+  A.set_rows(3);
+  A.set_cols(3);
+  A.shrink_to_fit();
+  EXPECT_EQ(A.row_capacity(), 3);
+  EXPECT_EQ(A.col_capacity(), 3);
+  EXPECT_TRUE(A == C + B);
+
+  // Copy assignment reuses storage that is large enough.
+  S21Matrix D(4, 4);
+  p = D.data();
+  D = C;
+  EXPECT_EQ(D.data(), p);
+  EXPECT_EQ(D.rows(), 3);
+  EXPECT_TRUE(D == C);
+  EXPECT_THROW(D.reserve(-1, 2), std::length_error);
+}
+
+TEST(S21MatrixTest, ResizeAppendRows) {
+  int cols = 5, n = 1000, reallocations = 0;
+  S21Int64Matrix A(0, cols);
+  const std::int64_t *p = nullptr;
+  for (int i = 0; i < n; i++) {
+    A.set_rows(i + 1);
+    if (A.data() != p) reallocations++;
+    p = A.data();
+    for (int j = 0; j < cols; j++) A(i, j) = i * cols + j;
+  }
+  // Geometric growth: about log2(n) reallocations.
+  EXPECT_LE(reallocations, 11);
+  EXPECT_GE(A.row_capacity(), n);
+  for (int k = 0; k < n * cols; k++) EXPECT_EQ(A(k / cols, k % cols), k);
+
+  S21Matrix B;
+  B.set_cols(3);
+  B.set_rows(2);
+  EXPECT_EQ(B.rows(), 2);
+  EXPECT_EQ(B.cols(), 3);
+  EXPECT_TRUE(B == S21Matrix(2, 3));
+  B.set_rows(0);
+  EXPECT_EQ(B.matrix(), nullptr);
+}
+
 TEST(S21MatrixTest, EmptyConstructor) {
   S21Matrix A;
   EXPECT_EQ(A.rows(), 0);
@@ -79,7 +243,9 @@ TEST(S21MatrixTest, MoveConstructor) {
       A(i, j) = a;
       exp(i, j) = a;
     }
+  double *p = A.matrix()[0];
   S21Matrix B(std::move(A));
+  EXPECT_EQ(B.matrix()[0], p);
   EXPECT_EQ(B.rows(), exp.rows());
   EXPECT_EQ(B.cols(), exp.cols());
   ASSERT_NE(B.matrix(), nullptr);
@@ -92,6 +258,21 @@ TEST(S21MatrixTest, MoveConstructor) {
   EXPECT_EQ(A.matrix(), nullptr);
 }
 
+TEST(S21MatrixTest, ContiguousStorage) {
+  int rows = 5, cols = 7;
+  S21Matrix A(rows, cols);
+  for (int i = 0; i < rows; i++)
+    for (int j = 0; j < cols; j++) A(i, j) = i * cols + j;
+  double **p = A.matrix();
+  ASSERT_NE(p, nullptr);
+  EXPECT_EQ(A.matrix(), p);
+  for (int i = 0; i < rows; i++) EXPECT_EQ(p[i], p[0] + i * cols);
+  for (int k = 0; k < rows * cols; k++) EXPECT_EQ(p[0][k], k);
+
+  S21Matrix B(0, 0);
+  EXPECT_EQ(B.matrix(), nullptr);
+}
+
 TEST(S21MatrixTest, EqMatrix) {
   srand(time(nullptr));
   int rows = rand() % 100 + 1, cols = rand() % 100 + 1;
@@ -109,6 +290,229 @@ TEST(S21MatrixTest, EqMatrix) {
   EXPECT_FALSE(B.EqMatrix(A));
 }
 
+TEST(S21MatrixTest, SimdLevels) {
+  srand(time(nullptr));
+  int n = 37;
+  // Halves after scaling by 1e6, huge values and non-finite values exercise
+  // every branch of the vector rounding.
+  std::vector<double> a(n), b(n);
+  for (int j = 0; j < n; j++) a[j] = (double)rand() / rand() - 0.5;
+  a[1] = 2.5e-6;
+  a[2] = -2.5e-6;
+  a[3] = 0.4999999e-6;
+  a[4] = 1e300;
+  a[5] = -INFINITY;
+  a[6] = 9007199254740993.0;
+  b = a;
+  std::vector<std::vector<double>> perturb = {
+      {0, 1e-7}, {1, 0.5e-6}, {2, -0.5e-6}, {3, 0.2e-7}, {5, 1}, {6, 2}};
+  s21::SimdLevel best = s21::DetectSimdLevel();
+  for (int level = 0; level <= static_cast<int>(best); level++) {
+    s21::SetSimdLevel(static_cast<s21::SimdLevel>(level));
+    EXPECT_EQ(s21::ActiveSimdLevel(), static_cast<s21::SimdLevel>(level));
+    EXPECT_TRUE(s21::EqRow(a.data(), b.data(), n));
+    for (auto &p : perturb) {
+      int j = static_cast<int>(p[0]);
+      b[j] += p[1];
+      bool exp = std::round(a[j] * 1e6) == std::round(b[j] * 1e6);
+      EXPECT_EQ(s21::EqRow(a.data(), b.data(), n), exp)
+          << s21::SimdLevelName(s21::ActiveSimdLevel()) << " at " << j;
+      b[j] = a[j];
+    }
+    b[n - 1] = NAN;
+    EXPECT_FALSE(s21::EqRow(a.data(), b.data(), n));
+    b[n - 1] = a[n - 1];
+
+    std::vector<double> sum = a, exp = a;
+    s21::AddRow(sum.data(), b.data(), n);
+    s21::SubRow(sum.data(), a.data(), n);
+    s21::ScaleRow(sum.data(), 0.5, n);
+    s21::AxpyRow(sum.data(), -3, b.data(), n);
+    for (int j = 0; j < n; j++) exp[j] = (a[j] + b[j] - a[j]) * 0.5 - 3 * b[j];
+    EXPECT_EQ(std::memcmp(sum.data(), exp.data(), sizeof(double) * n), 0);
+  }
+  s21::SetSimdLevel(best);
+}
+
+TEST(S21MatrixTest, SimdLevelsElementTypes) {
+  srand(time(nullptr));
+  int n = 1000 + rand() % 50;
+  std::vector<float> fa(n), fb(n);
+  std::vector<std::int64_t> ia(n), ib(n);
+  std::vector<std::complex<double>> ca(n), cb(n);
+  for (int j = 0; j < n; j++) {
+    fa[j] = fb[j] = (float)rand() / rand() - 0.5f;
+    ia[j] = ib[j] = rand() - RAND_MAX / 2;
+    ca[j] = cb[j] = {(double)rand() / rand(), (double)rand() / rand() - 1};
+  }
+  s21::SimdLevel best = s21::DetectSimdLevel();
+  for (int level = 0; level <= static_cast<int>(best); level++) {
+    s21::SetSimdLevel(static_cast<s21::SimdLevel>(level));
+    int j = rand() % n;
+    EXPECT_TRUE(s21::EqRow(fa.data(), fb.data(), n));
+    fb[j] = fa[j] + 1e-6f * std::max(1.0f, std::fabs(fa[j]));
+    EXPECT_TRUE(s21::EqRow(fa.data(), fb.data(), n));
+    fb[j] = fa[j] + 1e-4f * std::max(1.0f, std::fabs(fa[j]));
+    EXPECT_FALSE(s21::EqRow(fa.data(), fb.data(), n));
+    fb[j] = fa[j];
+    ib[j]++;
+    EXPECT_FALSE(s21::EqRow(ia.data(), ib.data(), n));
+    ib[j]--;
+    EXPECT_TRUE(s21::EqRow(ia.data(), ib.data(), n));
+    cb[j] += std::complex<double>(0, 1e-3);
+    EXPECT_FALSE(s21::EqRow(ca.data(), cb.data(), n));
+    cb[j] = ca[j];
+
+    std::vector<float> fsum = fa, fexp = fa;
+    s21::AddRow(fsum.data(), fb.data(), n);
+    s21::ScaleRow(fsum.data(), 0.5f, n);
+    s21::AxpyRow(fsum.data(), -3.0f, fb.data(), n);
+    for (int k = 0; k < n; k++) fexp[k] = (fa[k] + fb[k]) * 0.5f - 3 * fb[k];
+    EXPECT_EQ(std::memcmp(fsum.data(), fexp.data(), sizeof(float) * n), 0);
+
+    std::vector<std::int64_t> isum = ia, iexp = ia;
+    s21::SubRow(isum.data(), ib.data(), n);
+    s21::AddRow(isum.data(), ib.data(), n);
+    s21::ScaleRow(isum.data(), std::int64_t(-7), n);
+    s21::AxpyRow(isum.data(), std::int64_t(5), ib.data(), n);
+    for (int k = 0; k < n; k++) iexp[k] = ia[k] * -7 + 5 * ib[k];
+    EXPECT_EQ(isum, iexp);
+    // Overflow wraps around, in the vector loops and in the scalar tail.
+    constexpr std::int64_t kMax = std::numeric_limits<std::int64_t>::max();
+    std::vector<std::int64_t> big(n, kMax), one(n, 1);
+    s21::AddRow(big.data(), one.data(), n);
+    EXPECT_EQ(big, std::vector<std::int64_t>(n, -kMax - 1));
+    s21::SubRow(big.data(), one.data(), n);
+    s21::ScaleRow(big.data(), std::int64_t(2), n);
+    s21::AxpyRow(big.data(), std::int64_t(3), one.data(), n);
+    EXPECT_EQ(big, std::vector<std::int64_t>(n, 1));
+
+    std::complex<double> s(0.5, -2), t(-3, 0.25);
+    std::vector<std::complex<double>> csum = ca, cexp(n);
+    s21::ScaleRow(csum.data(), s, n);
+    s21::AxpyRow(csum.data(), t, cb.data(), n);
+    for (int k = 0; k < n; k++) {
+      double re = ca[k].real() * s.real() - ca[k].imag() * s.imag();
+      double im = ca[k].imag() * s.real() + ca[k].real() * s.imag();
+      cexp[k] = {re + (cb[k].real() * t.real() - cb[k].imag() * t.imag()),
+                 im + (cb[k].imag() * t.real() + cb[k].real() * t.imag())};
+    }
+    EXPECT_EQ(csum, cexp) << s21::SimdLevelName(s21::ActiveSimdLevel());
+  }
+  s21::SetSimdLevel(best);
+}
+
+TEST(S21MatrixTest, NearRowLevels) {
+  srand(time(nullptr));
+  auto check = [](auto zero) {
+    using T = decltype(zero);
+    // Past one early-exit chunk, with a vector tail.
+    int n = 601;
+    std::vector<T> a(n), b;
+    for (int j = 0; j < n; j++) a[j] = (T)rand() / rand() - T(0.5);
+    T inf = std::numeric_limits<T>::infinity();
+    T tiny = std::numeric_limits<T>::denorm_min();
+    a[1] = -T(0);
+    a[2] = inf;
+    a[3] = -tiny;
+    a[4] = std::numeric_limits<T>::max();
+    auto steps = [](T x, T y, int k) {
+      T lo = std::min(x, y), hi = std::max(x, y);
+      for (int s = 0; s < k && lo < hi; s++) lo = std::nextafter(lo, hi);
+      return lo == hi;
+    };
+    auto near = [&](T x, T y, s21::Tolerance tol) {
+      if (x == y) return true;
+      if (std::isnan(x) || std::isnan(y)) return false;
+      T d = std::fabs(x - y);
+      switch (tol.mode) {
+        case s21::EqMode::kAbsolute:
+          return d <= T(tol.value);
+        case s21::EqMode::kRelative:
+          return d <= std::max(std::fabs(x), std::fabs(y)) * T(tol.value);
+        default:
+          return steps(x, y, static_cast<int>(tol.value));
+      }
+    };
+    std::vector<s21::Tolerance> tols = {
+        s21::Tolerance::Absolute(0), s21::Tolerance::Absolute(1e-6),
+        s21::Tolerance::Relative(1e-6), s21::Tolerance::Ulp(0),
+        s21::Tolerance::Ulp(2)};
+    s21::SimdLevel best = s21::DetectSimdLevel();
+    for (int level = 0; level <= static_cast<int>(best); level++) {
+      s21::SetSimdLevel(static_cast<s21::SimdLevel>(level));
+      for (s21::Tolerance tol : tols) {
+        b = a;
+        EXPECT_TRUE(s21::NearRow(a.data(), b.data(), n, tol));
+        for (int j : {1, 2, 3, 4, 300, n - 1, rand() % n}) {
+          T x = a[j];
+          for (T y : {std::nextafter(x, inf), std::nextafter(x, -inf),
+                      std::nextafter(std::nextafter(x, inf), inf),
+                      std::nextafter(std::nextafter(std::nextafter(x, inf),
+                                                    inf),
+                                     inf),
+                      x + T(1e-7), x * T(1 + 1e-7), -x, T(0), inf,
+                      std::numeric_limits<T>::quiet_NaN()}) {
+            b[j] = y;
+            EXPECT_EQ(s21::NearRow(a.data(), b.data(), n, tol),
+                      near(x, y, tol))
+                << s21::SimdLevelName(s21::ActiveSimdLevel()) << " mode "
+                << static_cast<int>(tol.mode) << " at " << j << ": " << x
+                << " vs " << y;
+          }
+          b[j] = x;
+        }
+      }
+    }
+    s21::SetSimdLevel(best);
+  };
+  check(0.0);
+  check(0.0f);
+}
+
+TEST(S21MatrixTest, EqMatrixTolerance) {
+  S21Matrix A(3, 4), B(3, 4);
+  for (int k = 0; k < 12; k++) A(k / 4, k % 4) = B(k / 4, k % 4) = k * 0.1;
+  B(2, 3) += 4e-7;
+  // Within the default six decimal places, but not within 1e-7.
+  EXPECT_TRUE(A == B);
+  EXPECT_FALSE(A.EqMatrix(B, s21::Tolerance::Absolute(1e-7)));
+  EXPECT_TRUE(A.EqMatrix(B, s21::Tolerance::Absolute(1e-6)));
+  EXPECT_TRUE(A.EqMatrix(B, s21::Tolerance::Relative(1e-6)));
+  EXPECT_FALSE(A.EqMatrix(B, s21::Tolerance::Ulp(1000)));
+  B(2, 3) = std::nextafter(A(2, 3), 2.0);
+  EXPECT_TRUE(A.EqMatrix(B, s21::Tolerance::Ulp(1)));
+  EXPECT_FALSE(A.EqMatrix(B, s21::Tolerance::Ulp(0)));
+  // Rounding to six places splits values that are 1e-12 apart.
+  A(0, 0) = 0.0000005 - 1e-12;
+  B(0, 0) = 0.0000005 + 1e-12;
+  EXPECT_FALSE(A == B);
+  EXPECT_TRUE(A.EqMatrix(B, s21::Tolerance::Absolute(1e-9)));
+  // Views, including minors, compare like matrices.
+  EXPECT_TRUE(A.EqMatrix(B.View(), s21::Tolerance::Absolute(1e-9)));
+  S21Matrix M = A.MinorView(0, 0);
+  EXPECT_TRUE(M.EqMatrix(B.MinorView(0, 0), s21::Tolerance::Ulp(1)));
+  EXPECT_FALSE(M.EqMatrix(B.MinorView(1, 1), s21::Tolerance::Ulp(1)));
+  EXPECT_FALSE(A.EqMatrix(M, s21::Tolerance::Absolute(1)));
+  EXPECT_THROW((void)A.EqMatrix(B, s21::Tolerance::Absolute(-1)),
+               std::logic_error);
+  EXPECT_THROW((void)A.EqMatrix(B, s21::Tolerance::Relative(NAN)),
+               std::logic_error);
+  EXPECT_THROW((void)S21Matrix().EqMatrix(B, s21::Tolerance::Ulp(1)),
+               std::logic_error);
+
+  S21Int64Matrix I(1, 3), J(1, 3);
+  I(0, 2) = 100;
+  J(0, 2) = 103;
+  EXPECT_TRUE(I.EqMatrix(J, s21::Tolerance::Ulp(3)));
+  EXPECT_FALSE(I.EqMatrix(J, s21::Tolerance::Absolute(2)));
+  EXPECT_TRUE(I.EqMatrix(J, s21::Tolerance::Relative(0.03)));
+  S21ComplexMatrix C(1, 2), D(1, 2);
+  D(0, 1) = {1e-9, -1e-9};
+  EXPECT_TRUE(C.EqMatrix(D, s21::Tolerance::Absolute(1e-9)));
+  EXPECT_FALSE(C.EqMatrix(D, s21::Tolerance::Relative(0.5)));
+}
+
 TEST(S21MatrixTest, SumMatrix) {
   srand(time(nullptr));
   int rows = rand() % 100 + 1, cols = rand() % 100 + 1;
@@ -177,6 +581,187 @@ TEST(S21MatrixTest, MulMatrix) {
   EXPECT_THROW(A.MulMatrix(C), std::logic_error);
 }
 
+TEST(S21MatrixTest, MulMatrixBlocked) {
+  srand(time(nullptr));
+  // Shapes that cross the packing and cache-block edges.
+  int shapes[][3] = {{150, 300, 70}, {5, 600, 3}, {260, 9, 513}, {97, 97, 97}};
+  for (auto &shape : shapes) {
+    int m = shape[0], k = shape[1], n = shape[2];
+    S21Matrix A(m, k), B(k, n), exp(m, n);
+    // Small integers keep every partial sum exact in any summation order.
+    for (int i = 0; i < m; i++)
+      for (int j = 0; j < k; j++) A(i, j) = rand() % 7 - 3;
+    for (int i = 0; i < k; i++)
+      for (int j = 0; j < n; j++) B(i, j) = rand() % 7 - 3;
+    for (int i = 0; i < m; i++)
+      for (int r = 0; r < k; r++)
+        for (int j = 0; j < n; j++) exp(i, j) += A(i, r) * B(r, j);
+    A.MulMatrix(B);
+    ASSERT_EQ(A.rows(), m);
+    ASSERT_EQ(A.cols(), n);
+    for (int i = 0; i < m; i++)
+      for (int j = 0; j < n; j++) ASSERT_EQ(A(i, j), exp(i, j));
+  }
+}
+
+TEST(S21MatrixTest, ThreadCountInvariance) {
+  srand(time(nullptr));
+  int m = 300, k = 257, n = 530;
+  S21Matrix A(m, k), B(k, n);
+  for (int i = 0; i < m; i++)
+    for (int j = 0; j < k; j++) A(i, j) = (double)rand() / RAND_MAX - 0.5;
+  for (int i = 0; i < k; i++)
+    for (int j = 0; j < n; j++) B(i, j) = (double)rand() / RAND_MAX - 0.5;
+  S21Matrix res[2];
+  int threads[2] = {1, 4};
+  for (int t = 0; t < 2; t++) {
+    s21::SetNumThreads(threads[t]);
+    EXPECT_EQ(s21::NumThreads(), threads[t]);
+    S21Matrix C = A * B;
+    C += C * 0.25;
+    C -= A * B;
+    res[t] = C.Transpose();
+  }
+  s21::SetNumThreads(0);
+  ASSERT_EQ(res[0].rows(), n);
+  ASSERT_EQ(res[1].cols(), m);
+  EXPECT_EQ(std::memcmp(res[0].matrix()[0], res[1].matrix()[0],
+                        sizeof(double) * m * n),
+            0);
+}
+
+TEST(S21MatrixTest, ThreadPoolWorkStealing) {
+  s21::ThreadPool pool(3);
+  EXPECT_EQ(pool.size(), 3);
+  std::vector<int> hits(1000);
+  int nested = 0;
+  for (int round = 0; round < 20; round++)
+    pool.Run(hits.size(), [&](int i) {
+      hits[i]++;
+      // Nested calls run inline on the worker.
+      if (i == 0) pool.Run(3, [&](int) { nested++; });
+    });
+  EXPECT_EQ(nested, 60);
+  for (size_t i = 0; i < hits.size(); i++) EXPECT_EQ(hits[i], 20);
+}
+
+TEST(S21MatrixTest, ThreadPoolExceptions) {
+  s21::ThreadPool pool(4);
+  std::atomic<int> ran{0};
+  EXPECT_THROW(pool.Run(1000,
+                        [&](int i) {
+                          ran++;
+                          if (i % 100 == 7) throw std::runtime_error("task");
+                        }),
+               std::runtime_error);
+  // The pool stays usable, also after a nested run threw.
+  ran = 0;
+  pool.Run(1000, [&](int) { ran++; });
+  EXPECT_EQ(ran, 1000);
+  EXPECT_THROW(pool.Run(8,
+                        [&](int) {
+                          pool.Run(2, [](int) { throw std::bad_alloc(); });
+                        }),
+               std::bad_alloc);
+  pool.Run(8, [&](int) { pool.Run(2, [&](int) { ran++; }); });
+  EXPECT_EQ(ran, 1016);
+
+  // Concurrent callers of the shared pool get the same one.
+  std::vector<std::thread> threads;
+  std::vector<s21::ThreadPool*> seen(8);
+  for (int t = 0; t < 8; t++)
+    threads.emplace_back([&seen, t] { seen[t] = &s21::Pool(); });
+  for (auto& thread : threads) thread.join();
+  for (s21::ThreadPool* p : seen) EXPECT_EQ(p, seen[0]);
+}
+
+TEST(S21MatrixTest, GemmUpdate) {
+  srand(time(nullptr));
+  int m = 70, k = 90, n = 50;
+  S21Matrix A(m, k), B(k, n), C(m, n), exp(m, n);
+  for (int i = 0; i < m; i++)
+    for (int j = 0; j < k; j++) A(i, j) = rand() % 9 - 4;
+  for (int i = 0; i < k; i++)
+    for (int j = 0; j < n; j++) B(i, j) = rand() % 9 - 4;
+  for (int i = 0; i < m; i++)
+    for (int j = 0; j < n; j++) C(i, j) = rand() % 9 - 4;
+  S21Matrix AB = A * B;
+  for (int i = 0; i < m; i++)
+    for (int j = 0; j < n; j++) exp(i, j) = 0.5 * C(i, j) + 2 * AB(i, j);
+  double *p = C.matrix()[0];
+  C.Gemm(2, A, B, 0.5);
+  EXPECT_EQ(C.matrix()[0], p);
+  EXPECT_TRUE(C == exp);
+
+  // Aliased operands still give the right answer.
+  S21Matrix D(k, k), DD(k, k);
+  for (int i = 0; i < k; i++)
+    for (int j = 0; j < k; j++) D(i, j) = rand() % 5;
+  DD = D * D;
+  D.Gemm(1, D, D, 0);
+  EXPECT_TRUE(D == DD);
+
+  EXPECT_THROW(C.Gemm(1, B, A, 1), std::logic_error);
+  EXPECT_THROW(AB.Gemm(1, A, B.Transpose(), 1), std::logic_error);
+  S21Matrix empty;
+  EXPECT_THROW(empty.Gemm(1, A, B, 1), std::logic_error);
+}
+
+TEST(S21MatrixTest, AxpyUpdate) {
+  srand(time(nullptr));
+  int rows = rand() % 100 + 1, cols = rand() % 100 + 1;
+  S21Matrix X(rows, cols), Y(rows, cols), exp(rows, cols);
+  for (int i = 0; i < rows; i++)
+    for (int j = 0; j < cols; j++) {
+      X(i, j) = (double)rand() / rand();
+      Y(i, j) = (double)rand() / rand();
+      exp(i, j) = Y(i, j) + 1.5 * X(i, j);
+    }
+  Y.Axpy(1.5, X);
+  for (int i = 0; i < rows; i++)
+    for (int j = 0; j < cols; j++) EXPECT_EQ(Y(i, j), exp(i, j));
+  EXPECT_THROW(Y.Axpy(1, S21Matrix(rows + 1, cols)), std::logic_error);
+}
+
+TEST(S21MatrixTest, UpdatesDoNotAllocate) {
+  // Single-threaded: the serial path calls the body directly.
+  s21::SetNumThreads(1);
+  S21Matrix X(8, 8), Y(8, 8);
+  for (int i = 0; i < 8; i++)
+    for (int j = 0; j < 8; j++) X(i, j) = i - j;
+  Y.Axpy(2, X);
+  long before = global_news.load();
+  for (int r = 0; r < 10; r++) Y.Axpy(0.5, X);
+  EXPECT_EQ(global_news.load() - before, 0);
+
+  // On the pool. Each participant's GEMM packing buffers are created on its
+  // first product, so one blocking task per thread warms up all of them.
+  int n = 300;
+  s21::SetNumThreads(4);
+  S21Matrix A(n, n), B(n, n), C(n, n), W(64, 64);
+  for (int i = 0; i < n; i++)
+    for (int j = 0; j < n; j++) {
+      A(i, j) = (i * 7 + j) % 11 - 5;
+      B(i, j) = (i + j * 3) % 13 - 6;
+    }
+  std::atomic<int> arrived{0};
+  s21::Pool().Run(4, [&](int) {
+    S21Matrix w(64, 64);
+    w.Gemm(1, W, W, 0);
+    arrived++;
+    while (arrived < 4) std::this_thread::yield();
+  });
+  C.Gemm(1, A, B, 0);
+  C.Axpy(-1, A);
+  before = global_news.load();
+  for (int r = 0; r < 5; r++) {
+    C.Gemm(1, A, B, 0.5);
+    C.Axpy(-1, A);
+  }
+  EXPECT_EQ(global_news.load() - before, 0);
+  s21::SetNumThreads(0);
+}
+
 TEST(S21MatrixTest, Transpose) {
   srand(time(nullptr));
   int rows = rand() % 100 + 1, cols = rand() % 100 + 1;
@@ -243,6 +828,82 @@ TEST(S21MatrixTest, CalcComplements3x3) {
   EXPECT_TRUE(B.EqMatrix(exp));
 }
 
+TEST(S21MatrixTest, CalcComplementsSingular) {
+  int rows = 3, cols = 3;
+  S21Matrix A(rows, cols), exp(rows, cols);
+  A(0, 0) = 1;
+  A(0, 1) = 2;
+  A(0, 2) = 3;
+  A(1, 0) = 4;
+  A(1, 1) = 5;
+  A(1, 2) = 6;
+  A(2, 0) = 7;
+  A(2, 1) = 8;
+  A(2, 2) = 9;
+  exp(0, 0) = -3;
+  exp(0, 1) = 6;
+  exp(0, 2) = -3;
+  exp(1, 0) = 6;
+  exp(1, 1) = -12;
+  exp(1, 2) = 6;
+  exp(2, 0) = -3;
+  exp(2, 1) = 6;
+  exp(2, 2) = -3;
+  S21Matrix B = A.CalcComplements();
+  EXPECT_TRUE(B.EqMatrix(exp));
+
+  // Rank one: every 2x2 minor vanishes.
+  for (int i = 0; i < rows; i++)
+    for (int j = 0; j < cols; j++) {
+      A(i, j) = (i + 1) * (j + 2);
+      exp(i, j) = 0;
+    }
+  B = A.CalcComplements();
+  EXPECT_TRUE(B.EqMatrix(exp));
+
+  // Singular under partial pivoting but of full rank under complete
+  // pivoting: there is no null vector, the cofactors are computed directly.
+  double borderline[3][3] = {{0, 0, -1},
+                             {-1, -1, -1},
+                             {0.50000000000000067, 0.5, 1.2499999999999993}};
+  for (int i = 0; i < rows; i++)
+    for (int j = 0; j < cols; j++) A(i, j) = borderline[i][j];
+  for (int i = 0; i < rows; i++)
+    for (int j = 0; j < cols; j++) {
+      int r0 = i == 0, r1 = i == 2 ? 1 : 2, c0 = j == 0, c1 = j == 2 ? 1 : 2;
+      exp(i, j) = ((i + j) % 2 ? -1 : 1) *
+                  (A(r0, c0) * A(r1, c1) - A(r0, c1) * A(r1, c0));
+    }
+  B = A.CalcComplements();
+  EXPECT_TRUE(B.EqMatrix(exp, s21::Tolerance::Absolute(1e-12)));
+}
+
+TEST(S21MatrixTest, CalcComplementsMinors) {
+  srand(time(nullptr));
+  int n = 6;
+  S21Matrix A(n, n);
+  for (int i = 0; i < n; i++)
+    for (int j = 0; j < n; j++) A(i, j) = rand() % 10 - 5;
+  for (int singular = 0; singular < 2; singular++) {
+    // Second pass: make the last column a combination of the first two.
+    if (singular)
+      for (int i = 0; i < n; i++) A(i, n - 1) = A(i, 0) - 2 * A(i, 1);
+    S21Matrix B = A.CalcComplements();
+    for (int i = 0; i < n; i++)
+      for (int j = 0; j < n; j++) {
+        S21Matrix minor(n - 1, n - 1);
+        for (int r = 0, mr = 0; r < n; r++) {
+          if (r == i) continue;
+          for (int c = 0, mc = 0; c < n; c++)
+            if (c != j) minor(mr, mc++) = A(r, c);
+          mr++;
+        }
+        double exp = ((i + j) % 2 ? -1 : 1) * minor.Determinant();
+        EXPECT_NEAR(B(i, j), exp, 1e-6 * (1 + std::fabs(exp)));
+      }
+  }
+}
+
 TEST(S21MatrixTest, CalcComplementsNotSquare) {
   int rows = 2, cols = 3;
   S21Matrix A(rows, cols);
@@ -325,6 +986,28 @@ TEST(S21MatrixTest, Determinant3x3) {
   EXPECT_FLOAT_EQ(res, exp);
 }
 
+TEST(S21MatrixTest, BadlyScaledNonsingular) {
+  // Tiny pivots are not zeros when their row and column are just as small.
+  S21Matrix A(2, 2), I(2, 2);
+  A(0, 0) = 1e-20;
+  A(1, 1) = 1;
+  EXPECT_EQ(A.Determinant(), 1e-20);
+  S21Matrix inv = A.InverseMatrix();
+  EXPECT_EQ(inv(0, 0), 1e20);
+  EXPECT_EQ(inv(1, 1), 1);
+  EXPECT_EQ(A.CalcComplements()(0, 0), 1);
+  I(0, 0) = I(1, 1) = 1;
+  EXPECT_TRUE((A * A.Solve(I)).EqMatrix(I, s21::Tolerance::Absolute(0)));
+  A(0, 1) = 1;  // column 0 is tiny, row 0 is not
+  EXPECT_EQ(A.Determinant(), 1e-20);
+  EXPECT_NO_THROW((void)A.InverseMatrix());
+  // Rounding noise is still a zero, at any scale.
+  S21Matrix B(3, 3);
+  for (int k = 0; k < 9; k++) B(k / 3, k % 3) = (k + 1) * 1e-30;
+  EXPECT_EQ(B.Determinant(), 0);
+  EXPECT_THROW((void)B.InverseMatrix(), std::logic_error);
+}
+
 TEST(S21MatrixTest, Determinant4x4) {
   int rows = 4, cols = 4;
   S21Matrix A(rows, cols);
@@ -369,6 +1052,27 @@ TEST(S21MatrixTest, Determinant4x4) {
   EXPECT_FLOAT_EQ(res, exp);
 }
 
+TEST(S21MatrixTest, DeterminantLarge) {
+  int n = 200;
+  S21Matrix A(n, n);
+  // Upper triangular with a permuted row order: det = -prod(diag) for one
+  // swap of the first two rows.
+  for (int i = 0; i < n; i++)
+    for (int j = i; j < n; j++) A(i, j) = (i == j) ? 1.0 + (i % 3) : 0.5;
+  double exp = 1;
+  for (int i = 0; i < n; i++) exp *= 1.0 + (i % 3);
+  for (int j = 0; j < n; j++) std::swap(A(0, j), A(1, j));
+  EXPECT_DOUBLE_EQ(A.Determinant(), -exp);
+
+  // Rank-deficient: the last row is the sum of the first two.
+  S21Matrix B(12, 12);
+  srand(time(nullptr));
+  for (int i = 0; i < 11; i++)
+    for (int j = 0; j < 12; j++) B(i, j) = (double)rand() / RAND_MAX;
+  for (int j = 0; j < 12; j++) B(11, j) = B(0, j) + B(1, j);
+  EXPECT_NEAR(B.Determinant(), 0, 1e-9);
+}
+
 TEST(S21MatrixTest, DeterminantExcept) {
   int rows = 3, cols = 2;
   S21Matrix A;
@@ -466,6 +1170,21 @@ TEST(S21MatrixTest, InverseMatrix3x3) {
   EXPECT_TRUE(B.EqMatrix(exp));
 }
 
+TEST(S21MatrixTest, InverseMatrixLarge) {
+  srand(time(nullptr));
+  int n = 120;
+  S21Matrix A(n, n), I(n, n);
+  // Diagonally dominant, so well conditioned.
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) A(i, j) = (double)rand() / RAND_MAX - 0.5;
+    A(i, i) += n;
+    I(i, i) = 1;
+  }
+  S21Matrix B = A.InverseMatrix();
+  EXPECT_TRUE((A * B).EqMatrix(I));
+  EXPECT_TRUE((B * A).EqMatrix(I));
+}
+
 TEST(S21MatrixTest, InverseMatrixExcept) {
   int rows = 3, cols = 2;
   S21Matrix A;
@@ -475,6 +1194,61 @@ TEST(S21MatrixTest, InverseMatrixExcept) {
   EXPECT_THROW(A.InverseMatrix(), std::logic_error);
 }
 
+TEST(S21MatrixTest, Solve) {
+  // Spans several factorization blocks, with a last partial one.
+  // Pseudo-random entries, so pivoting moves rows.
+  int n = 150;
+  unsigned seed = 1;
+  auto next = [&seed] {
+    seed = seed * 1103515245 + 12345;
+    return static_cast<double>(seed >> 16 & 0x7fff) / 0x4000 - 1;
+  };
+  S21Matrix A(n, n), B(n, 3);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) A(i, j) = next();
+    for (int j = 0; j < 3; j++) B(i, j) = next();
+  }
+  S21Matrix X = A.Solve(B);
+  EXPECT_TRUE((A * X).EqMatrix(B, s21::Tolerance::Absolute(1e-9)));
+  // In place, column by column through a strided view and a span.
+  S21Matrix Y = B;
+  A.SolveInPlace(Y.View().ColView(1));
+  S21Matrix y = Y.View().ColView(1);
+  EXPECT_TRUE(
+      y.EqMatrix(X.View().ColView(1), s21::Tolerance::Absolute(1e-12)));
+  std::vector<double> x(n);
+  for (int i = 0; i < n; i++) x[i] = B(i, 2);
+  A.SolveInPlace(S21Span<double>(x.data(), n));
+  for (int i = 0; i < n; i++) EXPECT_NEAR(x[i], X(i, 2), 1e-12);
+  // A right-hand side sharing storage with the matrix.
+  S21Matrix I(n, n);
+  for (int i = 0; i < n; i++) I(i, i) = 1;
+  S21Matrix C = A;
+  C.SolveInPlace(C.View());
+  EXPECT_TRUE(C.EqMatrix(I, s21::Tolerance::Absolute(1e-12)));
+
+  S21ComplexMatrix Z(2, 2), b(2, 1);
+  Z(0, 0) = {0, 1};
+  Z(0, 1) = 2;
+  Z(1, 0) = 1;
+  Z(1, 1) = {1, -1};
+  b(0, 0) = {1, 2};
+  b(1, 0) = 3;
+  EXPECT_TRUE(
+      (Z * Z.Solve(b)).EqMatrix(b, s21::Tolerance::Absolute(1e-14)));
+}
+
+TEST(S21MatrixTest, SolveExcept) {
+  S21Matrix A(3, 3), B(3, 2);
+  EXPECT_THROW((void)A.Solve(B), std::logic_error);  // singular
+  EXPECT_THROW((void)S21Matrix().Solve(B), std::logic_error);
+  EXPECT_THROW((void)S21Matrix(3, 2).Solve(B), std::logic_error);
+  EXPECT_THROW((void)S21Matrix(2, 2).Solve(B), std::logic_error);
+  S21Int64Matrix N(3, 3);
+  N(0, 0) = N(1, 1) = N(2, 2) = 1;
+  EXPECT_THROW((void)N.Solve(S21Int64Matrix(3, 1)), std::logic_error);
+}
+
 TEST(S21MatrixTest, OperatorPlus) {
   srand(time(nullptr));
   int rows = rand() % 100 + 1, cols = rand() % 100 + 1;
@@ -542,6 +1316,58 @@ TEST(S21MatrixTest, OperatorAstMatrix) {
   EXPECT_THROW(A * C, std::logic_error);
 }
 
+TEST(S21MatrixTest, OperatorExpressionChain) {
+  srand(time(nullptr));
+  int rows = rand() % 100 + 1, cols = rand() % 100 + 1;
+  S21Matrix A(rows, cols), B(rows, cols), C(rows, cols), D(rows + 1, cols);
+  S21Matrix exp(rows, cols);
+  for (int i = 0; i < rows; i++)
+    for (int j = 0; j < cols; j++) {
+      A(i, j) = (double)rand() / rand();
+      B(i, j) = (double)rand() / rand();
+      C(i, j) = (double)rand() / rand();
+      exp(i, j) = A(i, j) + B(i, j) - C(i, j) * 2.0;
+    }
+  S21Matrix res = A + B - C * 2.0;
+  for (int i = 0; i < rows; i++)
+    for (int j = 0; j < cols; j++) EXPECT_EQ(res(i, j), exp(i, j));
+
+  // Assigning into one of the operands evaluates in place.
+  S21Matrix a0 = A;
+  A = 0.5 * (B - A) + A;
+  for (int i = 0; i < rows; i++)
+    for (int j = 0; j < cols; j++)
+      EXPECT_EQ(A(i, j), (B(i, j) - a0(i, j)) * 0.5 + a0(i, j));
+
+  EXPECT_THROW(A + B - D, std::logic_error);
+  EXPECT_THROW(S21Matrix() * 2.0, std::logic_error);
+
+  // Products with expression operands are materialized first. Small
+  // integers keep both sides exact whatever the summation order.
+  for (int i = 0; i < rows; i++)
+    for (int j = 0; j < cols; j++) {
+      A(i, j) = rand() % 9 - 4;
+      B(i, j) = rand() % 9 - 4;
+    }
+  S21Matrix T = A.Transpose();
+  EXPECT_TRUE(((A + B) * T).EqMatrix(A * T + B * T));
+}
+
+TEST(S21MatrixTest, CompoundOperatorsReturnReference) {
+  int rows = 3, cols = 4;
+  S21Matrix A(rows, cols), B(rows, cols);
+  for (int i = 0; i < rows; i++)
+    for (int j = 0; j < cols; j++) {
+      A(i, j) = i + j;
+      B(i, j) = 1;
+    }
+  S21Matrix &ref = (A += B) -= B * 3;
+  EXPECT_EQ(&ref, &A);
+  (A *= 2.0) += A - B;
+  for (int i = 0; i < rows; i++)
+    for (int j = 0; j < cols; j++) EXPECT_EQ(A(i, j), 4 * (i + j - 2) - 1);
+}
+
 TEST(S21MatrixTest, OperatorEq) {
   srand(time(nullptr));
   int rows = rand() % 100 + 1, cols = rand() % 100 + 1;
@@ -569,6 +1395,37 @@ TEST(S21MatrixTest, OperatorCopy) {
   EXPECT_TRUE(A == res);
 }
 
+TEST(S21MatrixTest, OperatorCopyReusesBuffer) {
+  int rows = 4, cols = 6;
+  S21Matrix A(rows, cols), B(rows, cols);
+  for (int i = 0; i < rows; i++)
+    for (int j = 0; j < cols; j++) A(i, j) = i - j;
+  double *p = B.matrix()[0];
+  B = A;
+  EXPECT_EQ(B.matrix()[0], p);
+  EXPECT_TRUE(B == A);
+  S21Matrix &self = B;
+  B = self;
+  EXPECT_TRUE(B == A);
+}
+
+TEST(S21MatrixTest, OperatorMove) {
+  int rows = 3, cols = 5;
+  S21Matrix A(rows, cols), B(1, 1), exp(rows, cols);
+  for (int i = 0; i < rows; i++)
+    for (int j = 0; j < cols; j++) {
+      A(i, j) = i * j + 0.5;
+      exp(i, j) = i * j + 0.5;
+    }
+  double *p = A.matrix()[0];
+  B = std::move(A);
+  EXPECT_EQ(B.matrix()[0], p);
+  EXPECT_TRUE(B == exp);
+  EXPECT_EQ(A.rows(), 0);
+  EXPECT_EQ(A.cols(), 0);
+  EXPECT_EQ(A.matrix(), nullptr);
+}
+
 TEST(S21MatrixTest, OperatorPlusEq) {
   srand(time(nullptr));
   int rows = rand() % 100 + 1, cols = rand() % 100 + 1;
@@ -650,32 +1507,750 @@ TEST(S21MatrixTest, OperatorParenthesis) {
 
   for (int i = 0; i < rows; i++)
     for (int j = 0; j < cols; j++) EXPECT_EQ(A(i, j), exp[i][j]);
-
-  EXPECT_THROW(A(rows + 1, cols), std::length_error);
-  EXPECT_THROW(A(rows, cols + 1), std::length_error);
-  EXPECT_THROW(A(-1, cols), std::length_error);
-  EXPECT_THROW(A(rows, -1), std::length_error);
 }
 
 TEST(S21MatrixTest, OperatorParenthesisConst) {
   srand(time(nullptr));
   int rows = 7, cols = 9;
-  const S21Matrix A(rows, cols);
+  S21Matrix B(rows, cols);
+  const S21Matrix &A = B;
   double exp[rows][cols];
   for (int i = 0; i < rows; i++)
     for (int j = 0; j < cols; j++) {
       double a = (double)rand() / rand();
-      A(i, j) = a;
+      B(i, j) = a;
       exp[i][j] = a;
     }
 
   for (int i = 0; i < rows; i++)
     for (int j = 0; j < cols; j++) EXPECT_EQ(A(i, j), exp[i][j]);
+  EXPECT_TRUE((std::is_same_v<decltype(A(0, 0)), const double &>));
+}
+
+TEST(S21MatrixTest, CheckedAt) {
+  srand(time(nullptr));
+  int rows = 7, cols = 9;
+  S21Matrix A(rows, cols);
+  for (int i = 0; i < rows; i++)
+    for (int j = 0; j < cols; j++) A.at(i, j) = (double)rand() / rand();
+  const S21Matrix &B = A;
+  for (int i = 0; i < rows; i++)
+    for (int j = 0; j < cols; j++) EXPECT_EQ(B.at(i, j), A(i, j));
+
+  EXPECT_THROW(A.at(rows + 1, cols), std::length_error);
+  EXPECT_THROW(A.at(rows, cols + 1), std::length_error);
+  EXPECT_THROW(A.at(-1, cols), std::length_error);
+  EXPECT_THROW(A.at(rows, -1), std::length_error);
+  EXPECT_THROW(B.at(rows + 1, cols), std::length_error);
+  EXPECT_THROW(B.at(rows, cols + 1), std::length_error);
+  EXPECT_THROW(B.at(-1, cols), std::length_error);
+  EXPECT_THROW(B.at(rows, -1), std::length_error);
+}
+
+TEST(S21MatrixTest, RowSpanAndData) {
+  int rows = 4, cols = 6;
+  S21Matrix A(rows, cols);
+  for (int i = 0; i < rows; i++) {
+    S21Span<double> r = A.row(i);
+    EXPECT_EQ(r.size(), cols);
+    for (double &x : r) x = i;
+    r[cols - 1] = -1;
+  }
+  const S21Matrix &B = A;
+  const double *data = B.data();
+  EXPECT_EQ(data, A.data());
+  for (int i = 0; i < rows; i++) {
+    S21Span<const double> r = B.row(i);
+    EXPECT_EQ(r.data(), data + i * B.stride());
+    for (int j = 0; j < cols; j++)
+      EXPECT_EQ(data[i * B.stride() + j], j == cols - 1 ? -1 : i);
+  }
+}
+
+TEST(S21MatrixTest, ViewBlocksAndSlices) {
+  int rows = 5, cols = 7;
+  S21Matrix A(rows, cols);
+  for (int i = 0; i < rows; i++)
+    for (int j = 0; j < cols; j++) A(i, j) = i * 10 + j;
+  S21MatrixView b = A.Block(1, 2, 3, 4);
+  EXPECT_EQ(b.rows(), 3);
+  EXPECT_EQ(b.cols(), 4);
+  EXPECT_EQ(b(0, 0), 12);
+  EXPECT_EQ(b(2, 3), 35);
+  b(1, 1) = -1;
+  EXPECT_EQ(A(2, 3), -1);
+  S21ConstMatrixView col = b.ColView(2);
+  S21ConstMatrixView row = b.RowView(2);
+  EXPECT_EQ(col.rows(), 3);
+  EXPECT_EQ(col(2, 0), 34);
+  EXPECT_EQ(row.cols(), 4);
+  EXPECT_EQ(row(0, 1), 33);
+  S21ConstMatrixView t = A.TransposedView();
+  EXPECT_EQ(t.rows(), cols);
+  EXPECT_EQ(t(6, 4), 46);
+  EXPECT_TRUE(S21Matrix(t) == A.Transpose());
+
+  // Writes through a block view, and views in element-wise expressions.
+  S21Matrix Z(2, 2);
+  A.Block(3, 5, 2, 2).Assign(Z + A.Block(0, 0, 2, 2) * 2);
+  EXPECT_EQ(A(3, 5), 0);
+  EXPECT_EQ(A(4, 6), 22);
+  A += A.TransposedView().Transposed();
+  EXPECT_EQ(A(4, 6), 44);
+
+  EXPECT_THROW((void)A.Block(4, 0, 2, 1), std::length_error);
+  EXPECT_THROW((void)b.Block(0, 0, 1, 5), std::length_error);
+  EXPECT_THROW((void)A.MinorView(0, 0).Minor(0, 0), std::logic_error);
+
+  // Offset blocks, rows and columns stay plainly strided, so kernels read
+  // them in place; blocks of a minor remap only across the skipped line.
+  EXPECT_TRUE(A.Block(1, 1, 2, 2).strided());
+  EXPECT_TRUE(A.View().RowView(2).strided());
+  EXPECT_TRUE(A.View().ColView(3).strided());
+  EXPECT_TRUE(b.Block(1, 1, 2, 2).strided());
+  S21ConstMatrixView m = A.MinorView(2, 3);
+  EXPECT_FALSE(m.Block(1, 1, 3, 3).strided());
+  EXPECT_EQ(m.Block(1, 1, 3, 3)(1, 2), A(3, 4));
+  EXPECT_TRUE(m.Block(2, 0, 2, 3).strided());
+  EXPECT_EQ(m.Block(2, 0, 2, 3)(0, 0), A(3, 0));
+  EXPECT_TRUE(m.Block(0, 3, 2, 2).strided());
+  EXPECT_EQ(m.Block(0, 3, 2, 2)(1, 1), A(1, 5));
+  S21ConstMatrixView blk = A.Block(1, 2, 4, 4);
+  S21Matrix minor = blk.Minor(1, 1);
+  EXPECT_EQ(minor(1, 1), A(3, 4));
+  EXPECT_TRUE(blk * A.Block(0, 1, 4, 2) ==
+              S21Matrix(blk) * S21Matrix(A.Block(0, 1, 4, 2)));
+}
+
+TEST(S21MatrixTest, ViewProductAndMinor) {
+  srand(time(nullptr));
+  int n = 40;
+  S21Matrix A(n, n), B(n, n);
+  for (int i = 0; i < n; i++)
+    for (int j = 0; j < n; j++) {
+      A(i, j) = rand() % 9 - 4;
+      B(i, j) = rand() % 9 - 4;
+    }
+  EXPECT_TRUE(A.TransposedView() * B == A.Transpose() * B);
+  S21Matrix E(A), F(A);
+  E += E.TransposedView() * 2;
+  F.SumMatrix(F.TransposedView());
+  EXPECT_TRUE(E == A + A.Transpose() * 2);
+  EXPECT_TRUE(F == A + A.Transpose());
+  S21Matrix blk = S21Matrix(A.Block(3, 5, 20, 10)) * B.Block(0, 2, 10, 30);
+  EXPECT_TRUE(A.Block(3, 5, 20, 10) * B.Block(0, 2, 10, 30) == blk);
+
+  // A product written into a block of one of its own operands.
+  S21Matrix C(A), exp(A);
+  exp.Block(0, 0, 10, 10).Assign(A.Block(0, 0, 10, n) * A.Block(0, 0, n, 10));
+  S21Matrix D(10, 10);
+  D.Gemm(1, C.Block(0, 0, 10, n), C.Block(0, 0, n, 10), 0);
+  C.Block(0, 0, 10, 10).Assign(D);
+  EXPECT_TRUE(C == exp);
+  C.MulMatrix(C.TransposedView());
+  EXPECT_TRUE(C == exp * exp.Transpose());
+
+  // Minor views agree with the cofactors.
+  S21Matrix S(4, 4), comp;
+  for (int i = 0; i < 4; i++)
+    for (int j = 0; j < 4; j++) S(i, j) = rand() % 7 - 3;
+  comp = S.CalcComplements();
+  for (int i = 0; i < 4; i++)
+    for (int j = 0; j < 4; j++) {
+      S21Matrix minor = S.MinorView(i, j);
+      EXPECT_NEAR(((i + j) % 2 ? -1 : 1) * minor.Determinant(), comp(i, j),
+                  1e-6);
+    }
+  S21Matrix M = S.MinorView(1, 2) * S.MinorView(0, 3);
+  EXPECT_TRUE(M == S21Matrix(S.MinorView(1, 2)) * S21Matrix(S.MinorView(0, 3)));
+}
+
+TEST(S21MatrixTest, FloatMatrix) {
+  srand(time(nullptr));
+  int n = 60;
+  S21FloatMatrix A(n, n), B(n, n);
+  S21Matrix Ad(n, n), Bd(n, n);
+  for (int i = 0; i < n; i++)
+    for (int j = 0; j < n; j++) {
+      Ad(i, j) = A(i, j) = rand() % 9 - 4 + (i == j ? 40 : 0);
+      Bd(i, j) = B(i, j) = rand() % 9 - 4;
+    }
+  S21FloatMatrix C = A * B + A * 2.5;
+  S21Matrix Cd = Ad * Bd + Ad * 2.5;
+  EXPECT_TRUE(C == S21FloatMatrix(Cd));
+  EXPECT_TRUE(S21Matrix(C) == Cd);
+  S21FloatMatrix I(n, n);
+  for (int i = 0; i < n; i++) I(i, i) = 1;
+  EXPECT_TRUE(A * A.InverseMatrix() == I);
+  // 40^60 is far outside the float range; a corner block is not.
+  S21FloatMatrix Af = A.Block(0, 0, 8, 8);
+  S21Matrix Adf = Ad.Block(0, 0, 8, 8);
+  EXPECT_NEAR(Af.Determinant() / Adf.Determinant(), 1, 1e-5);
+
+  // The float rule is relative for large values.
+  S21FloatMatrix X(1, 2), Y(1, 2);
+  X(0, 0) = Y(0, 0) = 1e6f;
+  Y(0, 0) += 1;
+  X(0, 1) = 1e-6f;
+  EXPECT_TRUE(X == Y);
+  Y(0, 0) += 100;
+  EXPECT_FALSE(X == Y);
+}
+
+TEST(S21MatrixTest, Int64Matrix) {
+  S21Int64Matrix A(3, 3), exp(3, 3);
+  std::int64_t a[3][3] = {{2, -1, 4}, {7, 3, -5}, {1, 8, 6}};
+  std::int64_t c[3][3] = {{58, -47, 53}, {38, 8, -17}, {-7, 38, 13}};
+  for (int i = 0; i < 3; i++)
+    for (int j = 0; j < 3; j++) {
+      A(i, j) = a[i][j];
+      exp(i, j) = c[i][j];
+    }
+  EXPECT_EQ(A.Determinant(), 375);
+  EXPECT_TRUE(A.CalcComplements() == exp);
+  S21Int64Matrix det(3, 3);
+  for (int i = 0; i < 3; i++) det(i, i) = 375;
+  EXPECT_TRUE(A * exp.Transpose() == det);
+  EXPECT_THROW(A.InverseMatrix(), std::logic_error);
+
+  // A unimodular factor leaves the exact determinant unchanged.
+  int n = 5;
+  S21Int64Matrix V(n, n);
+  for (int i = 0; i < n; i++)
+    for (int j = 0; j < n; j++) V(i, j) = (i == j ? 100 : 0) + i + 2 * j;
+  S21Int64Matrix L(n, n);
+  for (int i = 0; i < n; i++)
+    for (int j = 0; j <= i; j++) L(i, j) = i == j ? 1 : (i * j) % 5 - 2;
+  EXPECT_EQ((L * V).Determinant(), V.Determinant());
+  EXPECT_EQ(L.Determinant(), 1);
+}
+
+TEST(S21MatrixTest, ComplexMatrix) {
+  srand(time(nullptr));
+  using C = std::complex<double>;
+  int n = 30;
+  S21ComplexMatrix A(n, n), I(n, n);
+  for (int i = 0; i < n; i++) {
+    I(i, i) = 1;
+    for (int j = 0; j < n; j++) A(i, j) = C(rand() % 9 - 4, rand() % 5 - 2);
+  }
+  EXPECT_TRUE(A * A.InverseMatrix() == I);
+  S21ComplexMatrix adj = A.CalcComplements().Transpose();
+  S21ComplexMatrix det = I * A.Determinant();
+  S21ComplexMatrix prod = A * adj;
+  for (int i = 0; i < n; i++)
+    for (int j = 0; j < n; j++)
+      EXPECT_LT(std::abs(prod(i, j) - det(i, j)),
+                1e-9 * std::abs(A.Determinant()));
+
+  S21ComplexMatrix D(2, 2);
+  D(0, 0) = C(1, 1);
+  D(0, 1) = C(2, 0);
+  D(1, 0) = C(0, 3);
+  D(1, 1) = C(1, -1);
+  EXPECT_EQ(D.Determinant(), C(2, -6));
+  D *= C(0, 1);
+  EXPECT_EQ(D(0, 0), C(-1, 1));
+  EXPECT_EQ(D(1, 0), C(-3, 0));
+}
+
+template <class L, class R, class = void>
+struct CanMultiply : std::false_type {};
+template <class L, class R>
+struct CanMultiply<L, R,
+                   std::void_t<decltype(std::declval<L>() * std::declval<R>())>>
+    : std::true_type {};
+
+TEST(S21MatrixTest, FixedMatrixConstexpr) {
+  constexpr S21FixedMatrix<2, 3> A(1, 2, 3, 4, 5, 6);
+  constexpr S21FixedMatrix<3, 2> B = A.Transpose();
+  constexpr S21FixedMatrix<2, 2> P = A * B;
+  static_assert(P(0, 0) == 14 && P(0, 1) == 32 && P(1, 1) == 77);
+  static_assert(P.Determinant() == 54);
+  constexpr S21FixedMatrix<3, 3> M(2, 5, 7, 6, 3, 4, 5, -2, -3);
+  static_assert(M.Determinant() == -1);
+  constexpr S21FixedMatrix<3, 3> Inv = M.InverseMatrix();
+  static_assert(Inv(0, 0) == 1 && Inv(0, 1) == -1 && Inv(2, 2) == 24);
+  static_assert(M.CalcComplements()(1, 2) == 29);
+  static_assert((A + A - A * 2.0)(1, 2) == 0);
+  // Above the closed-form sizes, with a zero first pivot: elimination swaps
+  // rows at compile time.
+  constexpr S21FixedMatrix<5, 5> S(0, 2, 0, 0, 0, 0, 0, 2, 0, 0, 0, 0, 0, 2, 0,
+                                   0, 0, 0, 0, 2, 2, 0, 0, 0, 0);
+  static_assert(S.Determinant() == 32);
+  constexpr S21FixedMatrix<5, 5> SInv = S.InverseMatrix();
+  static_assert(SInv(1, 0) == 0.5 && SInv(0, 4) == 0.5 && SInv(0, 0) == 0);
+  constexpr S21FixedMatrix<5, 5, std::int64_t> SI(0, 2, 0, 0, 0, 0, 0, 2, 0, 0,
+                                                  0, 0, 0, 2, 0, 0, 0, 0, 0, 2,
+                                                  2, 0, 0, 0, 1);
+  static_assert(SI.Determinant() == 32);
+
+  static_assert(CanMultiply<S21FixedMatrix<2, 3>, S21FixedMatrix<3, 4>>());
+  static_assert(!CanMultiply<S21FixedMatrix<2, 3>, S21FixedMatrix<2, 3>>());
+  EXPECT_THROW((void)A.at(2, 0), std::length_error);
+  S21FixedMatrix<2, 2> Z;
+  EXPECT_THROW((void)Z.InverseMatrix(), std::logic_error);
+}
+
+TEST(S21MatrixTest, FixedMatrixMatchesDynamic) {
+  S21Matrix D(6, 6);
+  for (int i = 0; i < 6; i++)
+    for (int j = 0; j < 6; j++) D(i, j) = rand() % 19 - 9 + (i == j) * 20;
+  S21FixedMatrix<6, 6> F(D);
+  S21FixedMatrix<4, 4> G(D.Block(1, 1, 4, 4));
+  S21Matrix Dg(G);
+  EXPECT_TRUE(S21Matrix(F) == D);
+  EXPECT_TRUE(Dg == S21Matrix(D.Block(1, 1, 4, 4)));
+  double det = D.Determinant(), det_g = Dg.Determinant();
+  EXPECT_NEAR(F.Determinant(), det, 1e-9 * std::abs(det));
+  EXPECT_NEAR(G.Determinant(), det_g, 1e-9 * std::abs(det_g));
+  EXPECT_TRUE(S21Matrix(F.InverseMatrix()) == D.InverseMatrix());
+  EXPECT_TRUE(S21Matrix(G.InverseMatrix()) == Dg.InverseMatrix());
+  EXPECT_TRUE(S21Matrix(G.CalcComplements()) == Dg.CalcComplements());
+  EXPECT_TRUE(S21Matrix(F * F) == D * D);
+  EXPECT_TRUE(S21Matrix(D * F.View()) == D * D);
+  EXPECT_THROW((S21FixedMatrix<6, 5>(D)), std::logic_error);
+
+  S21FixedMatrix<5, 5, std::int64_t> I;
+  for (int i = 0; i < 5; i++)
+    for (int j = 0; j < 5; j++) I(i, j) = (i + 1) * (j + 2) % 7 + (i == j) * 9;
+  EXPECT_EQ(I.Determinant(), S21Int64Matrix(I).Determinant());
+}
+
+TEST(S21MatrixTest, PoolAllocatorSteadyState) {
+  s21::SetAllocator(s21::PoolAllocator());
+  int n = 40;
+  S21Matrix A(n, n), B;
+  for (int i = 0; i < n; i++)
+    for (int j = 0; j < n; j++) A(i, j) = rand() % 7 - 3 + (i == j) * n;
+  auto hot = [&] {
+    B = A.InverseMatrix();
+    S21Matrix C = A * B + A.CalcComplements() * 2.0;
+    C.Gemm(1, A, B, 1);
+    return A.Determinant() + C(0, 0);
+  };
+  double expected = hot();
+  s21::ResetAllocationStats();
+  {
+    s21::NoHeapScope scope;
+    long news = global_news.load();
+    for (int r = 0; r < 5; r++) EXPECT_EQ(hot(), expected);
+    // Nothing bypasses the allocator either.
+    EXPECT_EQ(global_news.load() - news, 0);
+    EXPECT_THROW(S21Matrix(1024, 1024), std::bad_alloc);
+  }
+  s21::AllocationStats stats = s21::GetAllocationStats();
+  EXPECT_GT(stats.allocations, 5 * 4);
+  EXPECT_EQ(stats.allocations, stats.deallocations);
+  EXPECT_EQ(stats.heap_allocations, 0);
+
+  s21::SetAllocator(s21::HeapAllocator());
+  S21Matrix D = A;
+  s21::ResetAllocationStats();
+  EXPECT_EQ(D.Determinant(), A.Determinant());
+  stats = s21::GetAllocationStats();
+  EXPECT_EQ(stats.heap_allocations, stats.allocations);
+  EXPECT_GT(stats.heap_bytes, 2L * n * n * 8);
+}
+
+TEST(S21MatrixTest, StrassenMatchesClassic) {
+  s21::SetStrassenCrossover(8);
+  const int shapes[][3] = {{64, 64, 64}, {45, 33, 70}, {17, 90, 31}};
+  for (const auto& shape : shapes) {
+    int m = shape[0], k = shape[1], n = shape[2];
+    S21Matrix A(m, k), B(n, k), C(m, n);
+    S21Int64Matrix IA(m, k), IB(k, n);
+    for (int i = 0; i < m; i++)
+      for (int j = 0; j < k; j++) IA(i, j) = rand() % 2001 - 1000;
+    for (int i = 0; i < k; i++)
+      for (int j = 0; j < n; j++) IB(i, j) = rand() % 2001 - 1000;
+    for (int i = 0; i < m; i++)
+      for (int j = 0; j < k; j++) A(i, j) = (double)rand() / RAND_MAX - 0.5;
+    for (int i = 0; i < n; i++)
+      for (int j = 0; j < k; j++) B(i, j) = (double)rand() / RAND_MAX - 0.5;
+    for (int i = 0; i < m; i++)
+      for (int j = 0; j < n; j++) C(i, j) = j - i;
+
+    // Integer products are exact either way.
+    S21Int64Matrix IC = IA;
+    IC.MulMatrix(IB, s21::MulAlgorithm::kStrassen);
+    EXPECT_TRUE(IC == IA * IB);
+
+    // Strided (transposed) operands and a general alpha and beta.
+    S21Matrix classic = C, strassen = C;
+    classic.Gemm(2, A, B.TransposedView(), -1);
+    strassen.Gemm(2, A, B.TransposedView(), -1, s21::MulAlgorithm::kStrassen);
+    EXPECT_TRUE(strassen == classic);
+  }
+  s21::SetStrassenCrossover(0);
+}
+
+TEST(S21MatrixTest, BatchMatchesSingleMatrices) {
+  const int shapes[][2] = {{4, 37}, {7, 100}, {32, 9}};
+  for (int level = 0; level <= static_cast<int>(s21::DetectSimdLevel());
+       level++) {
+    s21::SetSimdLevel(static_cast<s21::SimdLevel>(level));
+    for (const auto& shape : shapes) {
+      int n = shape[0], size = shape[1];
+      S21MatrixBatch A(size, n, n), B(size, n, n);
+      for (int b = 0; b < size; b++)
+        for (int i = 0; i < n; i++)
+          for (int j = 0; j < n; j++) {
+            A(b, i, j) = (double)rand() / RAND_MAX - 0.5;
+            B(b, i, j) = rand() % 9 - 4;
+          }
+      S21MatrixBatch AB = A * B, AT = A.Transpose(), inv = A.InverseMatrix();
+      std::vector<double> det = A.Determinant();
+      for (int b = 0; b < size; b++) {
+        S21Matrix a = A.Get(b);
+        EXPECT_EQ(det[b], a.Determinant());
+        EXPECT_TRUE(AB.Get(b) == a * B.Get(b));
+        EXPECT_TRUE(AT.Get(b) == a.Transpose());
+        EXPECT_TRUE(inv.Get(b) == a.InverseMatrix());
+      }
+    }
+    // Badly scaled but regular: each pivot is judged against its own row
+    // and column, not against the largest entry of the matrix.
+    S21MatrixBatch D(9, 2, 2);
+    for (int b = 0; b < 9; b++) {
+      D(b, 0, 0) = 1e-20 * (b + 1);
+      D(b, 1, 1) = 1;
+    }
+    std::vector<double> det = D.Determinant();
+    S21MatrixBatch inv = D.InverseMatrix();
+    for (int b = 0; b < 9; b++) {
+      S21Matrix d = D.Get(b);
+      EXPECT_EQ(det[b], d.Determinant());
+      EXPECT_EQ(det[b], 1e-20 * (b + 1));
+      EXPECT_TRUE(inv.Get(b) == d.InverseMatrix());
+    }
+  }
+  s21::SetSimdLevel(s21::DetectSimdLevel());
+}
+
+TEST(S21MatrixTest, BatchShapesAndErrors) {
+  S21FloatMatrixBatch A(20, 3, 5), B(20, 5, 2), C(19, 5, 2);
+  S21FloatMatrix m(3, 5);
+  for (int i = 0; i < 3; i++)
+    for (int j = 0; j < 5; j++) m(i, j) = i * 5 + j;
+  A.Set(17, m);
+  EXPECT_TRUE(A.Get(17) == m);
+  EXPECT_EQ(A.groups(), 2);
+  EXPECT_EQ(&A(17, 1, 2) - A.data(), (15 + 1 * 5 + 2) * 16 + 1);
+  EXPECT_EQ((A * B).cols(), 2);
+  EXPECT_EQ(A.Transpose().Get(17)(4, 2), 14);
+  EXPECT_THROW(A * C, std::logic_error);
+  EXPECT_THROW(A * A, std::logic_error);
+  EXPECT_THROW((void)A.Determinant(), std::logic_error);
+  EXPECT_THROW(A.Set(20, m), std::length_error);
+  EXPECT_THROW(A.Set(0, m.Transpose()), std::logic_error);
+
+  // One singular matrix fails the whole inverse; its determinant is zero.
+  S21FloatMatrixBatch D(5, 2, 2);
+  for (int b = 0; b < 5; b++) {
+    D(b, 0, 0) = D(b, 1, 1) = b + 1;
+    D(b, 0, 1) = 1;
+  }
+  EXPECT_EQ(D.Determinant()[3], 16);
+  EXPECT_NO_THROW((void)D.InverseMatrix());
+  D(2, 1, 0) = 3;
+  D(2, 1, 1) = 1;
+  EXPECT_EQ(D.Determinant()[2], 0);
+  EXPECT_THROW((void)D.InverseMatrix(), std::logic_error);
+}
+
+TEST(S21MatrixTest, BatchMove) {
+  S21MatrixBatch A(10, 4, 4);
+  A(9, 3, 2) = 7;
+  const double* data = A.data();
+  S21MatrixBatch B(std::move(A));
+  EXPECT_EQ(B.data(), data);
+  EXPECT_EQ(B(9, 3, 2), 7);
+  EXPECT_EQ(A.size(), 0);
+  EXPECT_EQ(A.data(), nullptr);
+  S21MatrixBatch C(3, 2, 2);
+  C = std::move(B);
+  EXPECT_EQ(C.data(), data);
+  EXPECT_EQ(C.size(), 10);
+  A = C;
+  EXPECT_NE(A.data(), data);
+  EXPECT_EQ(A(9, 3, 2), 7);
+}
+
+TEST(S21MatrixTest, SparseMatchesDense) {
+  S21Matrix A(6, 5), B(6, 5), X(5, 3);
+  for (int i = 0; i < 6; i++)
+    for (int j = 0; j < 5; j++) {
+      if ((i * 5 + j) % 4 == 0) A(i, j) = i - j + 0.5;
+      if ((i + j) % 3 == 0) B(i, j) = i * j - 2;
+    }
+  for (int i = 0; i < 5; i++)
+    for (int j = 0; j < 3; j++) X(i, j) = i + j * 0.25;
+  S21SparseMatrix a = S21SparseMatrix::FromDense(A);
+  S21SparseMatrix b = S21SparseMatrix::FromDense(B);
+  EXPECT_EQ(a.nnz(), 8);
+  EXPECT_DOUBLE_EQ(a.density(), 8.0 / 30);
+  EXPECT_TRUE(a.ToDense() == A);
+  EXPECT_DOUBLE_EQ(a.at(4, 0), 4.5);
+  EXPECT_DOUBLE_EQ(a.at(4, 1), 0);
+  EXPECT_TRUE((a + b).ToDense() == A + B);
+  EXPECT_TRUE((a - b).ToDense() == A - B);
+  EXPECT_TRUE(a.Transpose().ToDense() == A.Transpose());
+  EXPECT_TRUE(a * X == A * X);
+  EXPECT_TRUE(a * X.TransposedView().Transposed() == A * X);
+  S21Matrix Y(6, 4);
+  for (int i = 0; i < 6; i++)
+    for (int j = 0; j < 4; j++) Y(i, j) = i * 4 - j;
+  EXPECT_TRUE(a * Y.MinorView(2, 1) == A * Y.MinorView(2, 1));
+  S21Matrix x(5, 1);
+  for (int j = 0; j < 5; j++) x(j, 0) = j * j - 3;
+  std::vector<double> y = a.MulVector(S21Span<const double>(x.data(), 5));
+  S21Matrix ax = A * x;
+  for (int i = 0; i < 6; i++) EXPECT_DOUBLE_EQ(y[i], ax(i, 0));
+
+  // Cancellation drops entries, and so does scaling by zero.
+  EXPECT_EQ((a - a).nnz(), 0);
+  a *= 0.0;
+  EXPECT_EQ(a.nnz(), 0);
+  EXPECT_EQ(a.rows(), 6);
+}
+
+TEST(S21MatrixTest, SparseTripletsAndErrors) {
+  S21Int64SparseMatrix a = S21Int64SparseMatrix::FromTriplets(
+      3, 4, {{2, 1, 5}, {0, 3, 1}, {2, 1, -2}, {1, 0, 4}, {1, 2, 7},
+             {1, 2, -7}});
+  EXPECT_EQ(a.nnz(), 3);
+  std::vector<S21SparseEntry<std::int64_t>> coo = a.ToTriplets();
+  ASSERT_EQ(coo.size(), 3U);
+  EXPECT_EQ(coo[0].col, 3);
+  EXPECT_EQ(coo[1].row, 1);
+  EXPECT_EQ(coo[2].value, 3);
+  EXPECT_EQ(a.row_ptr()[3], 3);
+
+  S21SparseMatrix s = S21SparseMatrix::FromTriplets(
+      2, 2, {{0, 0, 1e-12}, {0, 1, 2}, {1, 1, -1e-9}});
+  s.Prune(1e-10);
+  EXPECT_EQ(s.nnz(), 2);
+  EXPECT_EQ(S21SparseMatrix::FromDense(s.ToDense(), 1e-6).nnz(), 1);
+
+  S21SparseMatrix t(2, 3);
+  double v[2] = {1, 2}, w[2];
+  EXPECT_THROW(S21SparseMatrix(-1, 2), std::length_error);
+  EXPECT_THROW((void)s.at(2, 0), std::length_error);
+  EXPECT_THROW(
+      (void)S21SparseMatrix::FromTriplets(2, 2, {{0, 2, 1.0}}),
+      std::length_error);
+  EXPECT_THROW(s + t, std::logic_error);
+  EXPECT_THROW(t * S21Matrix(2, 2), std::logic_error);
+  EXPECT_THROW(t.MulVector(S21Span<const double>(v, 2), S21Span<double>(w, 2)),
+               std::logic_error);
+}
+
+TEST(S21MatrixTest, MatrixFileRoundTrip) {
+  std::string path = testing::TempDir() + "s21_round_trip.mat";
+  S21Matrix A(5, 7);
+  for (int i = 0; i < 5; i++)
+    for (int j = 0; j < 7; j++) A(i, j) = i * 1.5 - j / 3.0;
+  SaveMatrix(path, A);
+  EXPECT_TRUE(LoadMatrix<double>(path) == A);
+  s21::FileHeader h = s21::ReadFileHeader(path);
+  EXPECT_EQ(h.rows, 5);
+  EXPECT_EQ(h.payload_offset % s21::kPayloadAlign, 0U);
+
+  // Mapped files are used in place; writable mappings reach the file.
+  S21MappedMatrix<double> m(path);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(m.data()) % s21::kAllocAlign,
+            0U);
+  EXPECT_TRUE(S21Matrix(m.View()) == A);
+  EXPECT_TRUE(m.View().Block(1, 2, 3, 2) * A.Transpose().Block(2, 0, 2, 4) ==
+              A.Block(1, 2, 3, 2) * A.Transpose().Block(2, 0, 2, 4));
+  EXPECT_THROW((void)m.MutableView(), std::logic_error);
+  {
+    S21MappedMatrix<double> w(path, S21MappedMatrix<double>::Mode::kReadWrite);
+    w.MutableView()(4, 6) = 42;
+    w.Sync();
+  }
+  EXPECT_EQ(m(4, 6), 42);
+  EXPECT_EQ(LoadMatrix<double>(path)(4, 6), 42);
+
+  // The streaming writer takes rows in pieces, from any view.
+  S21ComplexMatrix C(3, 2);
+  for (int i = 0; i < 3; i++)
+    for (int j = 0; j < 2; j++) C(i, j) = {i + 0.5, -j - 0.25};
+  S21MatrixWriter<std::complex<double>> writer(path, 3, 2);
+  writer.WriteRow(C.row(0));
+  writer.WriteRows(C.Transpose().TransposedView().Block(1, 0, 2, 2));
+  writer.Close();
+  EXPECT_TRUE(LoadMatrix<std::complex<double>>(path) == C);
+
+  // A file of the other byte order is converted on load.
+  std::FILE* f = std::fopen(path.c_str(), "r+b");
+  ASSERT_NE(f, nullptr);
+  std::vector<unsigned char> bytes(s21::kPayloadAlign + 6 * 16);
+  ASSERT_EQ(std::fread(bytes.data(), 1, bytes.size(), f), bytes.size());
+  auto swap = [&bytes](std::size_t at, std::size_t n) {
+    std::reverse(bytes.begin() + at, bytes.begin() + at + n);
+  };
+  for (std::size_t at = 8; at < 24; at += 4) swap(at, 4);
+  for (std::size_t at = 24; at < 64; at += 8) swap(at, 8);
+  for (std::size_t at = s21::kPayloadAlign; at < bytes.size(); at += 8)
+    swap(at, 8);
+  std::rewind(f);
+  ASSERT_EQ(std::fwrite(bytes.data(), 1, bytes.size(), f), bytes.size());
+  std::fclose(f);
+  bool swapped = false;
+  EXPECT_EQ(s21::ReadFileHeader(path, &swapped).cols, 2);
+  EXPECT_TRUE(swapped);
+  EXPECT_TRUE(LoadMatrix<std::complex<double>>(path) == C);
+  EXPECT_THROW(S21MappedMatrix<std::complex<double>>{path},
+               std::runtime_error);
+  std::remove(path.c_str());
+}
+
+TEST(S21MatrixTest, MatrixFileErrors) {
+  std::string path = testing::TempDir() + "s21_errors.mat";
+  S21FloatMatrix A(2, 3);
+  SaveMatrix(path, A);
+  EXPECT_EQ(LoadMatrix<float>(path).cols(), 3);
+  EXPECT_THROW((void)LoadMatrix<double>(path), std::runtime_error);
+  EXPECT_THROW(S21MappedMatrix<std::int64_t>{path}, std::runtime_error);
+  {
+    // Until Close() the file has no header.
+    S21MatrixWriter<float> writer(path, 2, 3);
+    writer.WriteRow(A.row(0));
+    EXPECT_THROW(writer.WriteRow(A.Transpose().row(0)), std::logic_error);
+    EXPECT_THROW(writer.WriteRows(A.View()), std::logic_error);
+    EXPECT_THROW(writer.Close(), std::logic_error);
+    EXPECT_EQ(writer.rows_written(), 1);
+  }
+  EXPECT_THROW((void)LoadMatrix<float>(path), std::runtime_error);
+  EXPECT_THROW((void)s21::ReadFileHeader(path + ".missing"),
+               std::system_error);
+
+  // Truncated payloads are rejected before any element is read.
+  SaveMatrix(path, A);
+  ASSERT_EQ(truncate(path.c_str(), s21::kPayloadAlign + 8), 0);
+  EXPECT_THROW((void)LoadMatrix<float>(path), std::runtime_error);
+  SaveMatrix(path, S21FloatMatrix());
+  EXPECT_EQ(S21MappedMatrix<float>(path).rows(), 0);
+
+  // Sizes that overflow 64 bits, or a wrong element size, in the header.
+  S21ComplexMatrix Z(1, 1);
+  SaveMatrix(path, Z);
+  s21::FileHeader h = s21::ReadFileHeader(path);
+  auto rewrite = [&path](const s21::FileHeader& header) {
+    std::FILE* f = std::fopen(path.c_str(), "r+b");
+    ASSERT_NE(f, nullptr);
+    ASSERT_EQ(std::fwrite(&header, sizeof(header), 1, f), 1u);
+    std::fclose(f);
+  };
+  s21::FileHeader bad = h;
+  bad.rows = bad.cols = 1L << 30;  // 2^60 elements of 16 bytes wrap to 0
+  rewrite(bad);
+  EXPECT_THROW((void)s21::ReadFileHeader(path), std::runtime_error);
+  bad = h;
+  bad.element_size = 8;
+  rewrite(bad);
+  EXPECT_THROW((void)s21::ReadFileHeader(path), std::runtime_error);
+  bad = h;
+  bad.rows = bad.cols = 16;  // the payload end wraps to 0
+  bad.payload_offset = -s21::kPayloadAlign;
+  rewrite(bad);
+  EXPECT_THROW((void)s21::ReadFileHeader(path), std::runtime_error);
+  rewrite(h);
+  EXPECT_TRUE(LoadMatrix<std::complex<double>>(path) == Z);
+  std::remove(path.c_str());
+}
+
+TEST(S21MatrixTest, OutOfCoreMatchesInMemory) {
+  std::string a_path = testing::TempDir() + "s21_ooc_a.mat";
+  std::string b_path = testing::TempDir() + "s21_ooc_b.mat";
+  std::string c_path = testing::TempDir() + "s21_ooc_c.mat";
+  // Small integers keep every summation order exact.
+  S21Matrix A(37, 53), B(53, 29);
+  for (int i = 0; i < 37; i++)
+    for (int j = 0; j < 53; j++) A(i, j) = (i * 7 + j * 3) % 11 - 5;
+  for (int i = 0; i < 53; i++)
+    for (int j = 0; j < 29; j++) B(i, j) = (i * 5 + j) % 9 - 4;
+  SaveMatrix(a_path, A);
+  SaveMatrix(b_path, B);
+
+  s21::OutOfCoreOptions options;
+  options.memory_budget = 5 * 8 * 8 * sizeof(double);
+  s21::OutOfCoreStats stats =
+      s21::MulMatrixFiles<double>(a_path, b_path, c_path, options);
+  EXPECT_EQ(stats.tile, 8);
+  EXPECT_LE(stats.buffer_bytes, options.memory_budget);
+  EXPECT_EQ(stats.tiles_written, 5 * 4);
+  EXPECT_EQ(stats.tiles_read, 2 * 5 * 4 * 7);
+  EXPECT_TRUE(LoadMatrix<double>(c_path) == A * B);
+
+  // Tiles larger than the operands, and a given tile size.
+  EXPECT_EQ(s21::MulMatrixFiles<double>(a_path, b_path, c_path).tile % 64, 0);
+  EXPECT_TRUE(LoadMatrix<double>(c_path) == A * B);
+  options.tile = 16;
+  options.memory_budget = 1 << 20;
+  s21::MulMatrixFiles<double>(a_path, b_path, c_path, options);
+  EXPECT_TRUE(S21Matrix(S21MappedMatrix<double>(c_path).View()) == A * B);
+
+  options.memory_budget = 100;
+  EXPECT_THROW(s21::MulMatrixFiles<double>(a_path, b_path, c_path, options),
+               std::length_error);
+  EXPECT_THROW(s21::MulMatrixFiles<double>(a_path, a_path, c_path),
+               std::logic_error);
+  EXPECT_THROW(s21::MulMatrixFiles<double>(b_path, a_path, a_path),
+               std::logic_error);
+  EXPECT_THROW(s21::MulMatrixFiles<float>(a_path, b_path, c_path),
+               std::runtime_error);
+  std::remove(a_path.c_str());
+  std::remove(b_path.c_str());
+  std::remove(c_path.c_str());
+}
 
-  EXPECT_THROW(A(rows + 1, cols), std::length_error);
-  EXPECT_THROW(A(rows, cols + 1), std::length_error);
-  EXPECT_THROW(A(-1, cols), std::length_error);
-  EXPECT_THROW(A(rows, -1), std::length_error);
+TEST(S21MatrixTest, StatsSnapshotAndDump) {
+  s21::ResetStats();
+  int small = s21::OpSizeClass(3, 4), large = s21::OpSizeClass(2000, 10);
+  EXPECT_STREQ(s21::OpSizeClassName(small), "<=4");
+  EXPECT_STREQ(s21::OpSizeClassName(large), ">1024");
+  s21::RecordOp(s21::Op::kProduct, small, 100, 1, 96);
+  s21::RecordOp(s21::Op::kProduct, small, 300, 0, 0);
+  s21::RecordCopy(64);
+  s21::StatsSnapshot stats = s21::GetStats();
+  const s21::OpStats& product =
+      stats.ops[static_cast<int>(s21::Op::kProduct)][small];
+  EXPECT_EQ(product.calls, 2);
+  EXPECT_EQ(product.total_ns, 400);
+  EXPECT_EQ(product.max_ns, 300);
+  EXPECT_EQ(product.matrices, 1);
+  EXPECT_EQ(product.histogram[6] + product.histogram[8], 2);
+  EXPECT_EQ(stats.copied_bytes, 64);
+  std::string json = s21::StatsJson(stats);
+  EXPECT_NE(json.find("{\"op\":\"Product\",\"size\":\"<=4\",\"calls\":2,"),
+            std::string::npos);
+  EXPECT_NE(json.find("\"histogram_ns\":{\"64\":1,\"256\":1}"),
+            std::string::npos);
+  EXPECT_NE(s21::StatsText(stats).find("Product"), std::string::npos);
+  s21::ResetStats();
+  EXPECT_EQ(s21::GetStats().deep_copies, 0);
+  EXPECT_EQ(s21::StatsText(s21::GetStats()).find("Product"),
+            std::string::npos);
+
+  // The hooks only record in builds with S21_STATS.
+  S21Matrix a(8, 8), b(a);
+  S21Matrix c = a * b + a;
+  (void)a.Determinant();
+  stats = s21::GetStats();
+  int n8 = s21::OpSizeClass(8, 8);
+  if (!s21::StatsEnabled()) {
+    EXPECT_EQ(stats.deep_copies, 0);
+    return;
+  }
+  EXPECT_EQ(stats.ops[static_cast<int>(s21::Op::kProduct)][n8].calls, 1);
+  EXPECT_EQ(stats.ops[static_cast<int>(s21::Op::kEvalExpr)][n8].calls, 1);
+  // b(a) and the working copy inside Determinant.
+  EXPECT_EQ(stats.deep_copies, 2);
+  EXPECT_EQ(stats.ops[static_cast<int>(s21::Op::kDeterminant)][n8].matrices,
+            1);
 }
 
 int main(int argc, char *argv[]) {